@@ -0,0 +1,666 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef __linux__
+# define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h> /* NAN */
+
+#include "time.h"
+#include "hash.h"
+#include "htable.h"
+
+/* Evaluate the speed and the quality of the hash functions from hash.h on
+   realistic key sets. This helps to choose one for a particular use.
+   Results are printed as CSV so that they can be compared across machines
+   and versions. Run with -b to compare ht_search_batch() with a loop of
+   ht_search() instead. */
+
+/* Each measure of the speed runs for at least this time. */
+#define MIN_NSEC 50000000
+
+/* Number of keys and number of input bits considered for the avalanche. */
+#define AVALANCHE_KEYS 1000
+#define AVALANCHE_BITS 128
+
+/* Key sets. Integer sets are made of integers stored in the pointers as
+   expected by the hash_int_*() functions. Others are strings. */
+enum hash_keys_set {
+  HASH_KEYS_SEQUENTIAL, /* integers 0, 1, 2, ... */
+  HASH_KEYS_IPV4,       /* IPv4 addresses clustered in a few subnets */
+  HASH_KEYS_WORDS,      /* short lower case words (6 to 12 characters) */
+  HASH_KEYS_URL,        /* URLs with a common prefix */
+  HASH_KEYS_LONG        /* long strings (256 to 1024 characters) */
+};
+
+struct hash_keys {
+  enum hash_keys_set set;
+  bool str;
+
+  unsigned int n;
+  const void **keys;
+  size_t size; /* total size of the strings */
+};
+
+static const char *set_names[] = {
+  [HASH_KEYS_SEQUENTIAL] = "sequential",
+  [HASH_KEYS_IPV4]       = "ipv4",
+  [HASH_KEYS_WORDS]      = "words",
+  [HASH_KEYS_URL]        = "url",
+  [HASH_KEYS_LONG]       = "long"
+};
+
+struct hash_eval {
+  double ns_per_key; /* average time to hash one key */
+  double mb_per_sec; /* throughput on the bytes of the keys (strings only) */
+
+  /* Worst bias of an output bit when an input bit is flipped. Zero when
+     each output bit flips with a probability of one half, one when some
+     output bit never or always flips. */
+  double avalanche;
+
+  /* Chi-squared of the distribution of the keys in as many buckets as
+     keys divided by its degrees of freedom. Values close to one are good,
+     larger values mean that keys are grouped in some buckets. */
+  double chi2;
+
+  /* Chains of an htable with as many buckets as keys, that is using the
+     same bucket selection and the maximal load factor before growing. */
+  double avg_chain; /* average length of the non-empty chains */
+  unsigned int max_chain;
+};
+
+/* The keys are searched by batches of at most this size. */
+#define MAX_BATCH 1024
+
+struct hash_eval_batch {
+  double loop_ns_per_key;  /* average time of ht_search() */
+  double batch_ns_per_key; /* average time of ht_search_batch() */
+};
+
+/* Keys are generated with xorshift so that they do not depend on the libc. */
+static uint32_t next_random(uint32_t *state)
+{
+  uint32_t x = *state;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+
+  return *state = x;
+}
+
+static char * random_str(uint32_t *state, unsigned int min, unsigned int max)
+{
+  unsigned int len = min + next_random(state) % (max - min + 1);
+  char *s = malloc(len + 1);
+  unsigned int i;
+
+  if(!s)
+    return NULL;
+
+  for(i = 0 ; i < len ; i++)
+    s[i] = 'a' + next_random(state) % 26;
+  s[len] = '\0';
+
+  return s;
+}
+
+static char * url_str(uint32_t *state, unsigned int i)
+{
+  char buf[128];
+  char *s;
+
+  sprintf(buf, "https://www.site%u.com/articles/%u/index.html?id=%u",
+          next_random(state) % 64, i, next_random(state) % 1000);
+
+  s = malloc(strlen(buf) + 1);
+  if(s)
+    strcpy(s, buf);
+
+  return s;
+}
+
+/* Return the key or NULL on allocation failure. */
+static const void * make_key(enum hash_keys_set set, uint32_t *state, unsigned int i)
+{
+  switch(set) {
+  case HASH_KEYS_SEQUENTIAL:
+    return (const void *)(uintptr_t)i;
+  case HASH_KEYS_IPV4:
+    /* hosts of 16 subnets in 10.0.0.0/8 */
+    return (const void *)(uintptr_t)(0x0a000000 | (i / 4096 * 37 % 256) << 16 | (i % 4096));
+  case HASH_KEYS_WORDS:
+    return random_str(state, 6, 12);
+  case HASH_KEYS_URL:
+    return url_str(state, i);
+  case HASH_KEYS_LONG:
+    return random_str(state, 256, 1024);
+  }
+
+  return NULL;
+}
+
+static void hash_keys_destroy(struct hash_keys *keys)
+{
+  unsigned int i;
+
+  if(keys->str)
+    for(i = 0 ; i < keys->n ; i++)
+      free((void *)keys->keys[i]);
+
+  free(keys->keys);
+  free(keys);
+}
+
+/* Generate n distinct keys of the specified set, or all the keys of the set
+   when it is smaller. The keys are always the same for a given set and
+   size. */
+static struct hash_keys * hash_keys_create(enum hash_keys_set set, unsigned int n)
+{
+  struct hash_keys *keys = malloc(sizeof(struct hash_keys));
+  uint32_t state = 0x2545f491;
+  htable_t seen  = NULL;
+  unsigned int i;
+
+  if(!keys)
+    return NULL;
+
+  keys->set  = set;
+  keys->str  = set != HASH_KEYS_SEQUENTIAL && set != HASH_KEYS_IPV4;
+  keys->n    = 0;
+  keys->size = 0;
+  keys->keys = malloc(n * sizeof(void *));
+
+  if(!keys->keys) {
+    free(keys);
+    return NULL;
+  }
+
+  /* IPv4 keys must be distinct so we generate each host of a subnet once */
+  if(set == HASH_KEYS_IPV4 && n > 16 * 4096)
+    n = 16 * 4096;
+
+  /* random strings may repeat so they are checked against the previous ones */
+  if(keys->str) {
+    seen = ht_create(n, hash_str_wy, htable_str_cmp, NULL);
+    if(!seen) {
+      hash_keys_destroy(keys);
+      return NULL;
+    }
+  }
+
+  for(i = 0 ; keys->n < n ; i++) {
+    const void *key = make_key(set, &state, i);
+
+    if(keys->str) {
+      void *found = key ? ht_insert(seen, key, (void *)key) : NULL;
+
+      if(!found) {
+        free((void *)key);
+        ht_destroy(seen);
+        hash_keys_destroy(keys);
+        return NULL;
+      }
+
+      if(found != key) {
+        free((void *)key);
+        continue;
+      }
+
+      keys->size += strlen(key);
+    }
+
+    keys->keys[keys->n++] = key;
+  }
+
+  if(seen)
+    ht_destroy(seen);
+
+  return keys;
+}
+
+static const char * hash_keys_name(const struct hash_keys *keys)
+{
+  return set_names[keys->set];
+}
+
+static void eval_speed(struct hash_eval *eval, uint32_t (*hash)(const void *), const struct hash_keys *keys)
+{
+  struct timespec begin, end;
+  unsigned long runs = 0;
+  uint64_t nsec;
+  volatile uint32_t sink = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &begin);
+
+  do {
+    unsigned int i;
+
+    for(i = 0 ; i < keys->n ; i++)
+      sink += hash(keys->keys[i]);
+    runs++;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    nsec = substract_nsec(&begin, &end);
+  } while(nsec < MIN_NSEC);
+
+  eval->ns_per_key = (double)nsec / (runs * keys->n);
+  eval->mb_per_sec = keys->str ? (double)keys->size * runs * 1000 / nsec : 0.;
+}
+
+/* Flip the input bit of a copy of the key and return the modified key.
+   Return false when the bit does not exist or when the string would be
+   truncated. */
+static bool flip(const struct hash_keys *keys, unsigned int idx, unsigned int bit,
+                 char *buf, const void **key)
+{
+  if(!keys->str) {
+    if(bit >= 32)
+      return false;
+
+    *key = (const void *)((uintptr_t)keys->keys[idx] ^ ((uintptr_t)1 << bit));
+    return true;
+  }
+  else {
+    const char *s = keys->keys[idx];
+    size_t len    = strlen(s);
+
+    if(bit / 8 >= len || !(s[bit / 8] ^ (1 << (bit % 8))))
+      return false;
+
+    memcpy(buf, s, len + 1);
+    buf[bit / 8] ^= 1 << (bit % 8);
+
+    *key = buf;
+    return true;
+  }
+}
+
+static bool eval_avalanche(struct hash_eval *eval, uint32_t (*hash)(const void *), const struct hash_keys *keys)
+{
+  unsigned long (*flips)[32] = calloc(AVALANCHE_BITS, sizeof(*flips));
+  unsigned long total[AVALANCHE_BITS] = { 0 };
+  unsigned int n = keys->n < AVALANCHE_KEYS ? keys->n : AVALANCHE_KEYS;
+  char *buf = NULL;
+  unsigned int i, bit, out;
+  double worst = 0.;
+
+  if(!flips)
+    return false;
+
+  if(keys->str) {
+    size_t max = 0;
+
+    for(i = 0 ; i < n ; i++)
+      if(strlen(keys->keys[i]) > max)
+        max = strlen(keys->keys[i]);
+
+    buf = malloc(max + 1);
+    if(!buf) {
+      free(flips);
+      return false;
+    }
+  }
+
+  for(i = 0 ; i < n ; i++) {
+    uint32_t h = hash(keys->keys[i]);
+
+    for(bit = 0 ; bit < AVALANCHE_BITS ; bit++) {
+      const void *key;
+      uint32_t diff;
+
+      if(!flip(keys, i, bit, buf, &key))
+        continue;
+
+      diff = h ^ hash(key);
+      total[bit]++;
+
+      for(out = 0 ; out < 32 ; out++)
+        if(diff & (1U << out))
+          flips[bit][out]++;
+    }
+  }
+
+  for(bit = 0 ; bit < AVALANCHE_BITS ; bit++) {
+    if(!total[bit])
+      continue;
+
+    for(out = 0 ; out < 32 ; out++) {
+      double bias = 2. * flips[bit][out] / total[bit] - 1.;
+
+      if(bias < 0)
+        bias = -bias;
+
+      if(bias > worst)
+        worst = bias;
+    }
+  }
+
+  eval->avalanche = worst;
+
+  free(buf);
+  free(flips);
+
+  return true;
+}
+
+/* Use the same buckets as htable with as many buckets as keys. */
+static bool eval_buckets(struct hash_eval *eval, uint32_t (*hash)(const void *), const struct hash_keys *keys)
+{
+  unsigned int nbuckets = 1;
+  unsigned int *buckets;
+  unsigned int i, used = 0;
+  double expected, chi2 = 0.;
+
+  while(nbuckets < keys->n)
+    nbuckets <<= 1;
+
+  buckets = calloc(nbuckets, sizeof(unsigned int));
+  if(!buckets)
+    return false;
+
+  for(i = 0 ; i < keys->n ; i++)
+    buckets[hash(keys->keys[i]) & (nbuckets - 1)]++;
+
+  expected        = (double)keys->n / nbuckets;
+  eval->max_chain = 0;
+
+  for(i = 0 ; i < nbuckets ; i++) {
+    double d = buckets[i] - expected;
+
+    chi2 += d * d / expected;
+
+    if(buckets[i])
+      used++;
+    if(buckets[i] > eval->max_chain)
+      eval->max_chain = buckets[i];
+  }
+
+  eval->chi2      = nbuckets > 1 ? chi2 / (nbuckets - 1) : 0.;
+  eval->avg_chain = used ? (double)keys->n / used : 0.;
+
+  free(buckets);
+
+  return true;
+}
+
+/* Evaluate a hash function on a key set. */
+static void hash_eval(struct hash_eval *eval, uint32_t (*hash)(const void *), const struct hash_keys *keys)
+{
+  memset(eval, 0, sizeof(struct hash_eval));
+
+  if(!keys->n)
+    return;
+
+  eval_speed(eval, hash, keys);
+
+  /* Without memory we only report NaN for the quality. */
+  if(!eval_avalanche(eval, hash, keys))
+    eval->avalanche = NAN;
+  if(!eval_buckets(eval, hash, keys))
+    eval->chi2 = eval->avg_chain = NAN;
+}
+
+static void hash_eval_print_header(FILE *out)
+{
+  fprintf(out, "hash,keys,n,ns_per_key,mb_per_sec,avalanche,chi2,avg_chain,max_chain\n");
+}
+
+static void hash_eval_print(FILE *out, const char *hash, const struct hash_keys *keys,
+                            const struct hash_eval *eval)
+{
+  fprintf(out, "%s,%s,%u,%.3f,%.1f,%.4f,%.4f,%.4f,%u\n",
+          hash, hash_keys_name(keys), keys->n,
+          eval->ns_per_key, eval->mb_per_sec,
+          eval->avalanche, eval->chi2, eval->avg_chain, eval->max_chain);
+}
+
+/* Keyed hashes are evaluated with a fixed seed. */
+static const unsigned char seed[HASH_SEED_SIZE] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+
+static uint32_t str_siphash(const void *key)
+{
+  return hash_str_siphash(key, seed);
+}
+
+static uint32_t str_halfsiphash(const void *key)
+{
+  return hash_str_halfsiphash(key, seed);
+}
+
+static const struct {
+  const char *name;
+  uint32_t (*hash)(const void *);
+  bool str;
+} hashes[] = {
+  { "str_djb2",        hash_str_djb2,     true },
+  { "str_sdbm",        hash_str_sdbm,     true },
+  { "str_pjw",         hash_str_pjw,      true },
+  { "str_elf",         hash_str_elf,      true },
+  { "str_knuth",       hash_str_knuth,    true },
+  { "str_jenkins",     hash_str_jenkins,  true },
+  { "str_kr",          hash_str_kr,       true },
+  { "str_crc32c",      hash_str_crc32c,   true },
+  { "str_wy",          hash_str_wy,       true },
+  { "str_siphash",     str_siphash,       true },
+  { "str_halfsiphash", str_halfsiphash,   true },
+  { "int_jenkins",     hash_int_jenkins,  false },
+  { "int_jacobson",    hash_int_jacobson, false },
+  { "int_knuth",       hash_int_knuth,    false },
+  { "int_crc32c",      hash_int_crc32c,   false }
+};
+
+/* Evaluate each hash function from hash.h on each compatible key set of n
+   keys and print the CSV report. */
+static void hash_eval_all(FILE *out, unsigned int n)
+{
+  enum hash_keys_set set;
+
+  hash_eval_print_header(out);
+
+  for(set = HASH_KEYS_SEQUENTIAL ; set <= HASH_KEYS_LONG ; set++) {
+    struct hash_keys *keys = hash_keys_create(set, n);
+    unsigned int i;
+
+    if(!keys)
+      continue;
+
+    for(i = 0 ; i < sizeof(hashes) / sizeof(hashes[0]) ; i++) {
+      struct hash_eval eval;
+
+      if(hashes[i].str != keys->str)
+        continue;
+
+      hash_eval(&eval, hashes[i].hash, keys);
+      hash_eval_print(out, hashes[i].name, keys, &eval);
+    }
+
+    hash_keys_destroy(keys);
+  }
+}
+
+/* Time the search of all the keys in the specified order, either one by one
+   or by batches, and return the average time per key. */
+static double time_search(htable_t ht, const void **order, unsigned int n,
+                          unsigned int batch)
+{
+  struct timespec begin, end;
+  unsigned long runs = 0;
+  uint64_t nsec;
+  void *out[MAX_BATCH];
+  volatile uintptr_t sink = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &begin);
+
+  do {
+    unsigned int i, j;
+
+    for(i = 0 ; i < n ; i += batch) {
+      unsigned int size = n - i < batch ? n - i : batch;
+
+      if(batch > 1)
+        ht_search_batch(ht, order + i, size, out);
+      else
+        out[0] = ht_search(ht, order[i], NULL);
+
+      for(j = 0 ; j < size ; j++)
+        sink += (uintptr_t)out[j];
+    }
+    runs++;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    nsec = substract_nsec(&begin, &end);
+  } while(nsec < MIN_NSEC);
+
+  return (double)nsec / (runs * n);
+}
+
+/* Compare ht_search_batch() with a loop of ht_search() on an htable filled
+   with the keys. The keys are searched in a random order. Return false when
+   there is not enough memory. */
+static bool hash_eval_batch(struct hash_eval_batch *eval, uint32_t (*hash)(const void *),
+                            const struct hash_keys *keys, unsigned int batch)
+{
+  htable_t ht;
+  const void **order;
+  uint32_t state = 0x2545f491;
+  unsigned int i;
+
+  if(!batch || batch > MAX_BATCH)
+    return false;
+
+  ht = ht_create(keys->n, hash, keys->str ? htable_str_cmp : htable_int_cmp, NULL);
+  if(!ht)
+    return false;
+
+  order = malloc(keys->n * sizeof(const void *));
+  if(!order) {
+    ht_destroy(ht);
+    return false;
+  }
+
+  /* the data are the keys themselves so that each search is checked */
+  for(i = 0 ; i < keys->n ; i++) {
+    ht_insert(ht, keys->keys[i], (void *)keys->keys[i]);
+    order[i] = keys->keys[i];
+  }
+
+  /* shuffle the lookups so that they do not follow the insertion order */
+  for(i = keys->n ; i > 1 ; i--) {
+    unsigned int j = next_random(&state) % i;
+    const void *swap = order[i - 1];
+
+    order[i - 1] = order[j];
+    order[j]     = swap;
+  }
+
+  eval->loop_ns_per_key  = time_search(ht, order, keys->n, 1);
+  eval->batch_ns_per_key = time_search(ht, order, keys->n, batch);
+
+  free(order);
+  ht_destroy(ht);
+
+  return true;
+}
+
+static void hash_eval_batch_print_header(FILE *out)
+{
+  fprintf(out, "hash,keys,n,batch,loop_ns_per_key,batch_ns_per_key,speedup\n");
+}
+
+static void hash_eval_batch_print(FILE *out, const char *hash, const struct hash_keys *keys,
+                                  unsigned int batch, const struct hash_eval_batch *eval)
+{
+  fprintf(out, "%s,%s,%u,%u,%.3f,%.3f,%.2f\n",
+          hash, hash_keys_name(keys), keys->n, batch,
+          eval->loop_ns_per_key, eval->batch_ns_per_key,
+          eval->loop_ns_per_key / eval->batch_ns_per_key);
+}
+
+/* Run the comparison on integer and string key sets of n keys for batches
+   of 32 and 256 keys and print the CSV report. */
+static void hash_eval_batch_all(FILE *out, unsigned int n)
+{
+  static const struct {
+    const char *name;
+    uint32_t (*hash)(const void *);
+    enum hash_keys_set set;
+  } runs[] = {
+    { "int_jenkins", hash_int_jenkins, HASH_KEYS_IPV4 },
+    { "str_wy",      hash_str_wy,      HASH_KEYS_WORDS }
+  };
+  static const unsigned int batches[] = { 32, 256 };
+  unsigned int i, j;
+
+  hash_eval_batch_print_header(out);
+
+  for(i = 0 ; i < sizeof(runs) / sizeof(runs[0]) ; i++) {
+    struct hash_keys *keys = hash_keys_create(runs[i].set, n);
+
+    if(!keys)
+      continue;
+
+    for(j = 0 ; j < sizeof(batches) / sizeof(batches[0]) ; j++) {
+      struct hash_eval_batch eval;
+
+      if(hash_eval_batch(&eval, runs[i].hash, keys, batches[j]))
+        hash_eval_batch_print(out, runs[i].name, keys, batches[j], &eval);
+    }
+
+    hash_keys_destroy(keys);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned int n = 100000;
+  bool batch     = false;
+  int i;
+
+  for(i = 1 ; i < argc ; i++) {
+    if(!strcmp(argv[i], "-b"))
+      batch = true;
+    else if(!(n = strtoul(argv[i], NULL, 10))) {
+      fprintf(stderr, "usage: %s [-b] [keys]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if(batch)
+    hash_eval_batch_all(stdout, n);
+  else
+    hash_eval_all(stdout, n);
+
+  return EXIT_SUCCESS;
+}
@@ -25,6 +25,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
+#include "slab.h"
 #include "bst.h"
 
 struct node {
@@ -32,23 +33,40 @@ struct node {
 
   struct node *left;
   struct node *right;
+
+  /* of the subtree rooted at this node */
+  int height;
+  unsigned int size;
 };
 
 struct bst {
   int  (*compare)(const void *, const void *);
   void (*destroy)(void *);
 
+  slab_t pool; /* nodes */
+
   struct node *root;
 };
 
-bst_t bst_create(int  (*compare)(const void *, const void *),
-                 void (*destroy)(void *))
+/* The nodes are carved from the arena when there is one. */
+static struct bst * create(int  (*compare)(const void *, const void *),
+                           void (*destroy)(void *),
+                           void *arena, size_t arena_size)
 {
   struct bst *bst = malloc(sizeof(struct bst));
 
   if(!bst)
     return NULL;
 
+  if(arena)
+    bst->pool = slab_create_arena(sizeof(struct node), arena, arena_size);
+  else
+    bst->pool = slab_create(sizeof(struct node), 0);
+  if(!bst->pool) {
+    free(bst);
+    return NULL;
+  }
+
   bst->compare = compare;
   bst->destroy = destroy;
   bst->root    = 0;
@@ -56,14 +74,108 @@ bst_t bst_create(int  (*compare)(const void *, const void *),
   return bst;
 }
 
+bst_t bst_create(int  (*compare)(const void *, const void *),
+                 void (*destroy)(void *))
+{
+  return create(compare, destroy, NULL, 0);
+}
+
+bst_t bst_create_arena(int  (*compare)(const void *, const void *),
+                       void (*destroy)(void *),
+                       void *arena, size_t arena_size)
+{
+  return create(compare, destroy, arena, arena_size);
+}
+
+static int height(const struct node *node)
+{
+  return node ? node->height : 0;
+}
+
+static unsigned int size(const struct node *node)
+{
+  return node ? node->size : 0;
+}
+
+static void update(struct node *node)
+{
+  int left  = height(node->left);
+  int right = height(node->right);
+
+  node->height = (left > right ? left : right) + 1;
+  node->size   = size(node->left) + size(node->right) + 1;
+}
+
+static struct node * rotate_left(struct node *node)
+{
+  struct node *right = node->right;
+
+  node->right = right->left;
+  right->left = node;
+
+  update(node);
+  update(right);
+
+  return right;
+}
+
+static struct node * rotate_right(struct node *node)
+{
+  struct node *left = node->left;
+
+  node->left  = left->right;
+  left->right = node;
+
+  update(node);
+  update(left);
+
+  return left;
+}
+
+/* Restore the AVL property on a node whose subtrees are balanced and
+   differ in height by two at most. Return the new root of the subtree. */
+static struct node * balance(struct node *node)
+{
+  int diff;
+
+  update(node);
+  diff = height(node->left) - height(node->right);
+
+  if(diff > 1) {
+    if(height(node->left->left) < height(node->left->right))
+      node->left = rotate_left(node->left);
+    return rotate_right(node);
+  }
+  else if(diff < -1) {
+    if(height(node->right->right) < height(node->right->left))
+      node->right = rotate_right(node->right);
+    return rotate_left(node);
+  }
+
+  return node;
+}
+
+/* Rebalance the nodes on the path from the modified node up to the root.
+   The path contains the references to each node from its parent. We go up
+   to the root as the size of each subtree on the path has changed. */
+static void rebalance(struct node ***path, int depth)
+{
+  while(depth--)
+    *path[depth] = balance(*path[depth]);
+}
+
 void * bst_insert(bst_t bst, void *data)
 {
+  struct node **path[BST_MAX_HEIGHT];
   struct node **ref = &bst->root;
   struct node *node = bst->root;
+  int depth = 0;
 
   while(node) {
     int comparison = bst->compare(data, node->data);
 
+    path[depth++] = ref;
+
     if(comparison < 0) {
       ref  = &node->left;
       node = node->left;
@@ -73,23 +185,28 @@ void * bst_insert(bst_t bst, void *data)
       node = node->right;
     }
     else {
-      bst->destroy(node->data);
+      if(bst->destroy)
+        bst->destroy(node->data);
       node->data = data;
       return data;
     }
   }
 
-  node = malloc(sizeof(struct node));
+  node = slab_alloc(bst->pool);
 
   if(!node)
     return NULL;
 
-  node->left  = NULL;
-  node->right = NULL;
-  node->data  = data;
+  node->left   = NULL;
+  node->right  = NULL;
+  node->data   = data;
+  node->height = 1;
+  node->size   = 1;
 
   *ref = node;
 
+  rebalance(path, depth);
+
   return data;
 }
 
@@ -113,80 +230,332 @@ void * bst_search(bst_t bst, void *data)
 
 void bst_delete(bst_t bst, void *data)
 {
+  struct node **path[BST_MAX_HEIGHT];
   struct node **ref = &bst->root;
   struct node *node = bst->root;
+  int depth = 0;
 
   while(node) {
     int comparison = bst->compare(data, node->data);
 
+    if(comparison == 0)
+      goto found;
+
+    path[depth++] = ref;
+
     if(comparison < 0) {
       ref  = &node->left;
       node = node->left;
     }
-    else if(comparison > 0) {
+    else {
       ref  = &node->right;
       node = node->right;
     }
-    else
-      goto found;
   }
 
   return;
 
 found:
-  bst->destroy(node->data);
+  if(bst->destroy)
+    bst->destroy(node->data);
 
+  /* With two children, the data is replaced by its successor's data and
+     the successor, which has no left child, is removed instead. */
   if(node->left && node->right) {
-    struct node *root = node;
+    struct node *target = node;
+
+    path[depth++] = ref;
+    ref  = &node->right;
     node = node->right;
+
     while(node->left) {
+      path[depth++] = ref;
       ref  = &node->left;
       node = node->left;
     }
 
-    root->data = node->data;
-    *ref       = node->right;
-    free(node);
+    target->data = node->data;
   }
-  else if(node->left) {
-    *ref = node->left;
-    free(node);
+
+  *ref = node->left ? node->left : node->right;
+  slab_free(bst->pool, node);
+
+  rebalance(path, depth);
+}
+
+void * bst_lower_bound(bst_t bst, const void *data)
+{
+  struct node *node = bst->root;
+  void *bound = NULL;
+
+  while(node) {
+    if(bst->compare(data, node->data) <= 0) {
+      bound = node->data;
+      node  = node->left;
+    }
+    else
+      node = node->right;
   }
-  else {
-    *ref = node->right;
-    free(node);
+
+  return bound;
+}
+
+void * bst_upper_bound(bst_t bst, const void *data)
+{
+  struct node *node = bst->root;
+  void *bound = NULL;
+
+  while(node) {
+    if(bst->compare(data, node->data) < 0) {
+      bound = node->data;
+      node  = node->left;
+    }
+    else
+      node = node->right;
   }
+
+  return bound;
 }
 
-static void inorder(struct node *node, void (*action)(void *data))
+unsigned int bst_count(bst_t bst)
 {
-  if(!node)
-    return;
+  return size(bst->root);
+}
 
-  inorder(node->left, action);
-  action(node->data);
-  inorder(node->right, action);
+unsigned int bst_rank(bst_t bst, const void *data)
+{
+  struct node *node = bst->root;
+  unsigned int rank = 0;
+
+  while(node) {
+    if(bst->compare(data, node->data) <= 0)
+      node = node->left;
+    else {
+      rank += size(node->left) + 1;
+      node  = node->right;
+    }
+  }
+
+  return rank;
+}
+
+void * bst_select(bst_t bst, unsigned int k)
+{
+  struct node *node = bst->root;
+
+  while(node) {
+    unsigned int left = size(node->left);
+
+    if(k < left)
+      node = node->left;
+    else if(k > left) {
+      k   -= left + 1;
+      node = node->right;
+    }
+    else
+      return node->data;
+  }
+
+  return NULL;
+}
+
+/* Push the node and its chain of left children. */
+static void push_left(struct bst_iter *iter, const struct node *node)
+{
+  for(; node ; node = node->left)
+    iter->stack[iter->depth++] = node;
+}
+
+void bst_iter_init(bst_t bst, struct bst_iter *iter)
+{
+  iter->depth = 0;
+  push_left(iter, bst->root);
+}
+
+void bst_iter_seek(bst_t bst, struct bst_iter *iter, const void *data)
+{
+  const struct node *node = bst->root;
+
+  /* only the nodes not less than the data remain to be visited */
+  iter->depth = 0;
+  while(node) {
+    if(bst->compare(data, node->data) <= 0) {
+      iter->stack[iter->depth++] = node;
+      node = node->left;
+    }
+    else
+      node = node->right;
+  }
+}
+
+bool bst_iter_next(struct bst_iter *iter, void **data)
+{
+  const struct node *node;
+
+  if(!iter->depth)
+    return false;
+
+  node = iter->stack[--iter->depth];
+  push_left(iter, node->right);
+
+  *data = node->data;
+  return true;
 }
 
 void bst_walk(bst_t bst, void (*action)(void *data))
 {
-  inorder(bst->root, action);
+  struct bst_iter iter;
+  void *data;
+
+  bst_iter_init(bst, &iter);
+
+  /* the right subtree is pushed before the action so the data may be destroyed */
+  while(bst_iter_next(&iter, &data))
+    action(data);
 }
 
-static void destroy(bst_t bst, struct node *node)
+void bst_walk_range(bst_t bst, const void *lo, const void *hi, void (*action)(void *data))
 {
-  if(!node)
-    return;
+  struct bst_iter iter;
+  void *data;
+
+  if(lo)
+    bst_iter_seek(bst, &iter, lo);
+  else
+    bst_iter_init(bst, &iter);
+
+  while(bst_iter_next(&iter, &data)) {
+    if(hi && bst->compare(data, hi) >= 0)
+      break;
+    action(data);
+  }
+}
+
+/* Build a perfectly balanced tree from sorted data. The nodes are taken in
+   order from an array so the tree is also laid out in order in memory. */
+static struct node * build(struct node *nodes, void **data, unsigned int n)
+{
+  struct node *node;
+  unsigned int mid = n / 2;
+
+  if(!n)
+    return NULL;
+
+  node        = &nodes[mid];
+  node->data  = data[mid];
+  node->left  = build(nodes, data, mid);
+  node->right = build(nodes + mid + 1, data + mid + 1, n - mid - 1);
+  update(node);
+
+  return node;
+}
+
+bst_t bst_build_sorted(int  (*compare)(const void *, const void *),
+                       void (*destroy)(void *),
+                       void **data, unsigned int n)
+{
+  struct bst *bst = bst_create(compare, destroy);
+  struct node *nodes;
+
+  if(!bst || !n)
+    return bst;
 
-  destroy(bst, node->left);
-  destroy(bst, node->right);
+  nodes = slab_alloc_array(bst->pool, n);
+  if(!nodes) {
+    bst_destroy(bst);
+    return NULL;
+  }
+
+  bst->root = build(nodes, data, n);
 
-  bst->destroy(node->data);
-  free(node);
+  return bst;
+}
+
+bst_t bst_merge(bst_t bst, bst_t other)
+{
+  struct bst_iter a, b;
+  void *data_a = NULL, *data_b = NULL;
+  struct node *nodes;
+  unsigned int na = size(bst->root);
+  unsigned int nb = size(other->root);
+  unsigned int n  = na + nb;
+  unsigned int m  = 0;
+  slab_t pool;
+  void **data;
+
+  if(!n)
+    goto RELEASE;
+
+  data = malloc(n * sizeof(void *));
+  pool = slab_create(sizeof(struct node), 0);
+  if(!data || !pool)
+    goto ERR;
+
+  nodes = slab_alloc_array(pool, n);
+  if(!nodes)
+    goto ERR;
+
+  /* merge both in-order walks, on equal data the other tree wins. The data
+     may be NULL so the walks are driven by the number of data left. */
+  bst_iter_init(bst, &a);
+  bst_iter_init(other, &b);
+  bst_iter_next(&a, &data_a);
+  bst_iter_next(&b, &data_b);
+
+  while(na || nb) {
+    int comparison;
+
+    if(!na)
+      comparison = 1;
+    else if(!nb)
+      comparison = -1;
+    else
+      comparison = bst->compare(data_a, data_b);
+
+    if(comparison < 0) {
+      data[m++] = data_a;
+      if(--na)
+        bst_iter_next(&a, &data_a);
+    }
+    else {
+      if(comparison == 0) {
+        if(bst->destroy)
+          bst->destroy(data_a);
+        if(--na)
+          bst_iter_next(&a, &data_a);
+      }
+
+      data[m++] = data_b;
+      if(--nb)
+        bst_iter_next(&b, &data_b);
+    }
+  }
+
+  slab_destroy(bst->pool);
+  bst->pool = pool;
+  bst->root = build(nodes, data, m);
+  free(data);
+
+RELEASE:
+  /* the data were moved so the other tree is only released */
+  slab_destroy(other->pool);
+  free(other);
+
+  return bst;
+
+ERR:
+  if(pool)
+    slab_destroy(pool);
+  free(data);
+  return NULL;
 }
 
 void bst_destroy(bst_t bst)
 {
-  destroy(bst, bst->root);
+  if(bst->destroy)
+    bst_walk(bst, bst->destroy);
+
+  /* the nodes are released slab per slab */
+  slab_destroy(bst->pool);
   free(bst);
 }
@@ -25,16 +25,59 @@
 #ifndef _BST_H_
 #define _BST_H_
 
+#include <stdlib.h>
+#include <stdbool.h>
+
 typedef struct bst * bst_t;
 
+/* The height of an AVL tree is at most 1.44 log2(n + 2). So this is enough
+   for any number of nodes that fits in memory. */
+#define BST_MAX_HEIGHT 96
+
+/* In-order iterator. It holds the path to the next node so it does not
+   allocate anything. The tree must not be modified while iterating. */
+struct bst_iter {
+  const void *stack[BST_MAX_HEIGHT];
+  int depth;
+};
+
+/* Binary sort trees are balanced (AVL) so that insertion, search and
+   deletion are always in O(log n) even when the data are inserted in order. */
+
 /* Create a new binary sort tree. The compare function compares two data and
    return an integer less than, equal to, or greater than zero if the first
    argument is found, respectively to be less than, to match, or be greater than
    the second argument. And the last function destroy the data when
-   necessary. */
+   necessary. It may be NULL when there is nothing to destroy. In this case
+   the tree is destroyed in one go without walking the nodes. */
 bst_t bst_create(int  (*compare)(const void *, const void *),
                  void (*destroy)(void *));
 
+/* Create a new binary sort tree whose nodes are carved from a caller
+   supplied arena instead of slabs allocated on the heap (see
+   slab_create_arena()). Insertions return NULL once the arena is exhausted.
+   The arena is not released when the tree is destroyed and must outlive
+   it. A tree merged with bst_merge() moves its nodes to the heap. */
+bst_t bst_create_arena(int  (*compare)(const void *, const void *),
+                       void (*destroy)(void *),
+                       void *arena, size_t arena_size);
+
+/* Create a perfectly balanced tree from n data sorted in ascending order
+   without duplicates. This is done in O(n) and the nodes are allocated in a
+   single block, in order. */
+bst_t bst_build_sorted(int  (*compare)(const void *, const void *),
+                       void (*destroy)(void *),
+                       void **data, unsigned int n);
+
+/* Merge the other tree into the first one in O(n + m). When both trees
+   contain equal data, the data from the other tree replace the data from
+   the first tree, which are destroyed. The merged tree is rebuilt
+   balanced with its nodes in a single block and the other tree is
+   destroyed, without destroying its data. Both trees must use the same
+   compare function. Return the first tree or NULL when there is not
+   enough memory, in which case both trees are left untouched. */
+bst_t bst_merge(bst_t bst, bst_t other);
+
 /* Insert the specifid data into the tree. This function return the specified
    data or NULL if it cannot be inuserted. The only reason why it can go wrong
    is an out of memory error on the heap. */
@@ -44,18 +87,48 @@ void * bst_insert(bst_t bst, void *data);
    if it was found in the tree. Otherwise it will return NULL. */
 void * bst_search(bst_t bst, void *data);
 
+/* Return the first data which is not less than (lower bound) or which is
+   greater than (upper bound) the specified data. Return NULL if there is
+   no such data. */
+void * bst_lower_bound(bst_t bst, const void *data);
+void * bst_upper_bound(bst_t bst, const void *data);
+
+/* Return the number of data inside the tree. */
+unsigned int bst_count(bst_t bst);
+
+/* Order statistics in O(log n). The rank is the number of data less than the
+   specified data. Select returns the k-th smallest data, starting from zero,
+   or NULL when k is not less than the number of data. For example the median
+   is bst_select(bst, bst_count(bst) / 2). */
+unsigned int bst_rank(bst_t bst, const void *data);
+void * bst_select(bst_t bst, unsigned int k);
+
 /* In-order walk through the binary sort tree and apply action function on
-   each entry, passing data to this function. Beware that this function may
-   provoke a stack overflow. */
+   each entry, passing data to this function. */
 void bst_walk(bst_t bst, void (*action)(void *));
 
+/* In-order walk through the data in the range [lo, hi). When lo is NULL
+   the walk starts from the first data, when hi is NULL it goes up to the
+   last data. */
+void bst_walk_range(bst_t bst, const void *lo, const void *hi, void (*action)(void *));
+
+/* Initialize an iterator on the first data of the tree. */
+void bst_iter_init(bst_t bst, struct bst_iter *iter);
+
+/* Initialize an iterator on the first data which is not less than the
+   specified data. */
+void bst_iter_seek(bst_t bst, struct bst_iter *iter, const void *data);
+
+/* Store the next data in order and return true, or return false at the end
+   of the tree. The data themselves may be NULL. */
+bool bst_iter_next(struct bst_iter *iter, void **data);
+
 /* Delete the entry specified from the binary sort tree. The destroy function
    passed at creation is used to destroy the data if necessary. */
 void bst_delete(bst_t bst, void *data);
 
 /* Destroy each entry from the binary search sort and then destroy the tree
-   itself. Beware that this function may provoke a stack overflow with a very
-   deep tree. */
+   itself. */
 void bst_destroy(bst_t bst);
 
 #endif /* _BST_H_ */
@@ -0,0 +1,584 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "slab.h"
+#include "btree.h"
+
+/* Maximal number of data in a leaf and of keys in an inner node. Nodes
+   are half full at least, except for the root. */
+#define LEAF_MAX  32
+#define LEAF_MIN  (LEAF_MAX / 2)
+#define INNER_MAX 32
+#define INNER_MIN (INNER_MAX / 2)
+
+/* Even when half full, a tree of this depth holds more data than memory. */
+#define MAX_DEPTH 32
+
+struct node {
+  /* number of data in a leaf or of keys in an inner node */
+  unsigned int count;
+};
+
+/* Each node has a slot in excess so that it may overflow before being split. */
+struct leaf {
+  struct node node;
+  struct leaf *next; /* next leaf in order */
+
+  void *data[LEAF_MAX + 1];
+};
+
+/* The key i is the smallest data of the child i + 1. So it is always a
+   data still present in the tree. */
+struct inner {
+  struct node node;
+
+  void *keys[INNER_MAX + 1];
+  struct node *children[INNER_MAX + 2];
+};
+
+struct btree {
+  int  (*compare)(const void *, const void *);
+  void (*destroy)(void *);
+
+  slab_t leaves;
+  slab_t inners;
+
+  struct node *root;
+  unsigned int height; /* one when the root is a leaf */
+  unsigned int count;
+};
+
+/* inner nodes visited from the root to a leaf */
+struct step {
+  struct inner *inner;
+  unsigned int idx; /* child followed */
+};
+
+btree_t bt_create(int  (*compare)(const void *, const void *),
+                  void (*destroy)(void *))
+{
+  struct btree *bt = malloc(sizeof(struct btree));
+  struct leaf *root;
+
+  if(!bt)
+    return NULL;
+
+  bt->leaves = slab_create(sizeof(struct leaf), 0);
+  bt->inners = slab_create(sizeof(struct inner), 0);
+  if(!bt->leaves || !bt->inners)
+    goto ERR;
+
+  root = slab_alloc(bt->leaves);
+  if(!root)
+    goto ERR;
+
+  root->node.count = 0;
+  root->next       = NULL;
+
+  bt->compare = compare;
+  bt->destroy = destroy;
+  bt->root    = &root->node;
+  bt->height  = 1;
+  bt->count   = 0;
+
+  return bt;
+
+ERR:
+  if(bt->leaves)
+    slab_destroy(bt->leaves);
+  if(bt->inners)
+    slab_destroy(bt->inners);
+  free(bt);
+  return NULL;
+}
+
+/* Return the index of the first data of the leaf which is not less than the
+   specified data. */
+static unsigned int leaf_search(const struct btree *bt, const struct leaf *leaf,
+                                const void *data, bool *found)
+{
+  unsigned int lo = 0, hi = leaf->node.count;
+
+  *found = false;
+
+  while(lo < hi) {
+    unsigned int mid = (lo + hi) / 2;
+    int comparison   = bt->compare(data, leaf->data[mid]);
+
+    if(comparison < 0)
+      hi = mid;
+    else if(comparison > 0)
+      lo = mid + 1;
+    else {
+      *found = true;
+      return mid;
+    }
+  }
+
+  return lo;
+}
+
+/* Return the index of the child which may contain the data. */
+static unsigned int inner_search(const struct btree *bt, const struct inner *inner,
+                                 const void *data)
+{
+  unsigned int lo = 0, hi = inner->node.count;
+
+  while(lo < hi) {
+    unsigned int mid = (lo + hi) / 2;
+
+    if(bt->compare(data, inner->keys[mid]) < 0)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+
+  return lo;
+}
+
+/* Go down to the leaf which may contain the data and record the path when
+   requested. */
+static struct leaf * descend(const struct btree *bt, const void *data, struct step *path)
+{
+  struct node *node = bt->root;
+  unsigned int level;
+
+  for(level = 1 ; level < bt->height ; level++) {
+    struct inner *inner = (struct inner *)node;
+    unsigned int idx    = inner_search(bt, inner, data);
+
+    if(path) {
+      path->inner = inner;
+      path->idx   = idx;
+      path++;
+    }
+
+    node = inner->children[idx];
+  }
+
+  return (struct leaf *)node;
+}
+
+static struct leaf * first_leaf(const struct btree *bt)
+{
+  struct node *node = bt->root;
+  unsigned int level;
+
+  for(level = 1 ; level < bt->height ; level++)
+    node = ((struct inner *)node)->children[0];
+
+  return (struct leaf *)node;
+}
+
+/* The first data of a leaf is also a key in the nearest ancestor where we
+   did not follow the first child. Replace it when this data changes. */
+static void replace_key(struct step *path, unsigned int depth, const void *old, void *data)
+{
+  while(depth--) {
+    if(path[depth].idx) {
+      void **key = &path[depth].inner->keys[path[depth].idx - 1];
+
+      if(*key == old)
+        *key = data;
+      return;
+    }
+  }
+}
+
+static void insert_key(struct inner *inner, unsigned int idx, void *key, struct node *child)
+{
+  unsigned int n = inner->node.count - idx;
+
+  memmove(&inner->keys[idx + 1], &inner->keys[idx], n * sizeof(void *));
+  memmove(&inner->children[idx + 2], &inner->children[idx + 1], n * sizeof(struct node *));
+
+  inner->keys[idx]         = key;
+  inner->children[idx + 1] = child;
+  inner->node.count++;
+}
+
+static void remove_key(struct inner *inner, unsigned int idx)
+{
+  unsigned int n = inner->node.count - idx - 1;
+
+  memmove(&inner->keys[idx], &inner->keys[idx + 1], n * sizeof(void *));
+  memmove(&inner->children[idx + 1], &inner->children[idx + 2], n * sizeof(struct node *));
+
+  inner->node.count--;
+}
+
+/* Split an overflowing leaf and then each overflowing ancestor. The new
+   nodes are allocated beforehand so that this cannot fail. */
+static void split(struct btree *bt, struct leaf *leaf, struct step *path, unsigned int depth,
+                  struct leaf *new_leaf, struct inner **new_inners)
+{
+  unsigned int half = leaf->node.count / 2;
+  struct node *child;
+  void *key;
+
+  new_leaf->node.count = leaf->node.count - half;
+  memcpy(new_leaf->data, &leaf->data[half], new_leaf->node.count * sizeof(void *));
+  new_leaf->next   = leaf->next;
+  leaf->next       = new_leaf;
+  leaf->node.count = half;
+
+  key   = new_leaf->data[0];
+  child = &new_leaf->node;
+
+  while(depth--) {
+    struct inner *inner = path[depth].inner;
+    struct inner *right;
+    unsigned int mid;
+
+    insert_key(inner, path[depth].idx, key, child);
+    if(inner->node.count <= INNER_MAX)
+      return;
+
+    /* the middle key moves up */
+    right = *new_inners++;
+    mid   = inner->node.count / 2;
+
+    right->node.count = inner->node.count - mid - 1;
+    memcpy(right->keys, &inner->keys[mid + 1], right->node.count * sizeof(void *));
+    memcpy(right->children, &inner->children[mid + 1], (right->node.count + 1) * sizeof(struct node *));
+    inner->node.count = mid;
+
+    key   = inner->keys[mid];
+    child = &right->node;
+  }
+
+  /* the root was split */
+  {
+    struct inner *root = *new_inners;
+
+    root->node.count  = 1;
+    root->keys[0]     = key;
+    root->children[0] = bt->root;
+    root->children[1] = child;
+
+    bt->root = &root->node;
+    bt->height++;
+  }
+}
+
+void * bt_insert(btree_t bt, void *data)
+{
+  struct step path[MAX_DEPTH];
+  struct inner *new_inners[MAX_DEPTH + 1];
+  struct leaf *new_leaf = NULL;
+  unsigned int depth    = bt->height - 1;
+  unsigned int needed   = 0;
+  unsigned int i, idx;
+  struct leaf *leaf;
+  bool found;
+
+  leaf = descend(bt, data, path);
+  idx  = leaf_search(bt, leaf, data, &found);
+
+  if(found) {
+    void *old = leaf->data[idx];
+
+    leaf->data[idx] = data;
+    if(idx == 0)
+      replace_key(path, depth, old, data);
+
+    if(bt->destroy)
+      bt->destroy(old);
+
+    return data;
+  }
+
+  /* Count the nodes that will be split, the root may also be created. */
+  if(leaf->node.count == LEAF_MAX) {
+    for(i = depth ; i && path[i - 1].inner->node.count == INNER_MAX ; i--)
+      needed++;
+    if(!i)
+      needed++;
+
+    new_leaf = slab_alloc(bt->leaves);
+    if(!new_leaf)
+      return NULL;
+
+    for(i = 0 ; i < needed ; i++) {
+      new_inners[i] = slab_alloc(bt->inners);
+
+      if(!new_inners[i]) {
+        while(i--)
+          slab_free(bt->inners, new_inners[i]);
+        slab_free(bt->leaves, new_leaf);
+        return NULL;
+      }
+    }
+  }
+
+  memmove(&leaf->data[idx + 1], &leaf->data[idx], (leaf->node.count - idx) * sizeof(void *));
+  leaf->data[idx] = data;
+  leaf->node.count++;
+  bt->count++;
+
+  if(new_leaf)
+    split(bt, leaf, path, depth, new_leaf, new_inners);
+
+  return data;
+}
+
+void * bt_search(btree_t bt, const void *data)
+{
+  struct leaf *leaf = descend(bt, data, NULL);
+  bool found;
+  unsigned int idx = leaf_search(bt, leaf, data, &found);
+
+  return found ? leaf->data[idx] : NULL;
+}
+
+void * bt_lower_bound(btree_t bt, const void *data)
+{
+  struct leaf *leaf = descend(bt, data, NULL);
+  bool found;
+  unsigned int idx = leaf_search(bt, leaf, data, &found);
+
+  if(idx == leaf->node.count) {
+    leaf = leaf->next;
+    idx  = 0;
+  }
+
+  return leaf ? leaf->data[idx] : NULL;
+}
+
+void * bt_upper_bound(btree_t bt, const void *data)
+{
+  struct leaf *leaf = descend(bt, data, NULL);
+  bool found;
+  unsigned int idx = leaf_search(bt, leaf, data, &found);
+
+  if(found)
+    idx++;
+
+  if(idx == leaf->node.count) {
+    leaf = leaf->next;
+    idx  = 0;
+  }
+
+  return leaf ? leaf->data[idx] : NULL;
+}
+
+/* Fix an underflowing leaf by borrowing from or merging with a sibling. */
+static void fix_leaf(struct btree *bt, struct leaf *leaf, struct step *step)
+{
+  struct inner *parent = step->inner;
+  unsigned int idx     = step->idx;
+
+  if(idx < parent->node.count) {
+    struct leaf *right = (struct leaf *)parent->children[idx + 1];
+
+    if(right->node.count > LEAF_MIN) {
+      leaf->data[leaf->node.count++] = right->data[0];
+      memmove(right->data, &right->data[1], --right->node.count * sizeof(void *));
+      parent->keys[idx] = right->data[0];
+    }
+    else {
+      memcpy(&leaf->data[leaf->node.count], right->data, right->node.count * sizeof(void *));
+      leaf->node.count += right->node.count;
+      leaf->next        = right->next;
+
+      remove_key(parent, idx);
+      slab_free(bt->leaves, right);
+    }
+  }
+  else {
+    struct leaf *left = (struct leaf *)parent->children[idx - 1];
+
+    if(left->node.count > LEAF_MIN) {
+      memmove(&leaf->data[1], leaf->data, leaf->node.count++ * sizeof(void *));
+      leaf->data[0]         = left->data[--left->node.count];
+      parent->keys[idx - 1] = leaf->data[0];
+    }
+    else {
+      memcpy(&left->data[left->node.count], leaf->data, leaf->node.count * sizeof(void *));
+      left->node.count += leaf->node.count;
+      left->next        = leaf->next;
+
+      remove_key(parent, idx - 1);
+      slab_free(bt->leaves, leaf);
+    }
+  }
+}
+
+/* Fix an underflowing inner node, keys rotate through the parent. */
+static void fix_inner(struct btree *bt, struct inner *inner, struct step *step)
+{
+  struct inner *parent = step->inner;
+  unsigned int idx     = step->idx;
+  unsigned int n       = inner->node.count;
+
+  if(idx < parent->node.count) {
+    struct inner *right = (struct inner *)parent->children[idx + 1];
+    unsigned int m      = right->node.count;
+
+    if(m > INNER_MIN) {
+      inner->keys[n]         = parent->keys[idx];
+      inner->children[n + 1] = right->children[0];
+      inner->node.count++;
+
+      parent->keys[idx] = right->keys[0];
+      memmove(right->keys, &right->keys[1], (m - 1) * sizeof(void *));
+      memmove(right->children, &right->children[1], m * sizeof(struct node *));
+      right->node.count--;
+    }
+    else {
+      inner->keys[n] = parent->keys[idx];
+      memcpy(&inner->keys[n + 1], right->keys, m * sizeof(void *));
+      memcpy(&inner->children[n + 1], right->children, (m + 1) * sizeof(struct node *));
+      inner->node.count += m + 1;
+
+      remove_key(parent, idx);
+      slab_free(bt->inners, right);
+    }
+  }
+  else {
+    struct inner *left = (struct inner *)parent->children[idx - 1];
+    unsigned int m     = left->node.count;
+
+    if(m > INNER_MIN) {
+      memmove(&inner->keys[1], inner->keys, n * sizeof(void *));
+      memmove(&inner->children[1], inner->children, (n + 1) * sizeof(struct node *));
+      inner->keys[0]     = parent->keys[idx - 1];
+      inner->children[0] = left->children[m];
+      inner->node.count++;
+
+      parent->keys[idx - 1] = left->keys[m - 1];
+      left->node.count--;
+    }
+    else {
+      left->keys[m] = parent->keys[idx - 1];
+      memcpy(&left->keys[m + 1], inner->keys, n * sizeof(void *));
+      memcpy(&left->children[m + 1], inner->children, (n + 1) * sizeof(struct node *));
+      left->node.count += n + 1;
+
+      remove_key(parent, idx - 1);
+      slab_free(bt->inners, inner);
+    }
+  }
+}
+
+void bt_delete(btree_t bt, const void *data)
+{
+  struct step path[MAX_DEPTH];
+  unsigned int depth = bt->height - 1;
+  struct leaf *leaf;
+  unsigned int idx;
+  bool found;
+  void *old;
+
+  leaf = descend(bt, data, path);
+  idx  = leaf_search(bt, leaf, data, &found);
+
+  if(!found)
+    return;
+
+  old = leaf->data[idx];
+  memmove(&leaf->data[idx], &leaf->data[idx + 1], (leaf->node.count - idx - 1) * sizeof(void *));
+  leaf->node.count--;
+  bt->count--;
+
+  /* the key for this leaf must not refer to the deleted data */
+  if(idx == 0 && leaf->node.count)
+    replace_key(path, depth, old, leaf->data[0]);
+
+  if(depth && leaf->node.count < LEAF_MIN) {
+    struct inner *inner;
+
+    fix_leaf(bt, leaf, &path[--depth]);
+
+    for(inner = path[depth].inner ;
+        depth && inner->node.count < INNER_MIN ;
+        inner = path[depth].inner)
+      fix_inner(bt, inner, &path[--depth]);
+  }
+
+  /* the root lost its last key */
+  if(bt->height > 1 && !bt->root->count) {
+    struct inner *root = (struct inner *)bt->root;
+
+    bt->root = root->children[0];
+    bt->height--;
+    slab_free(bt->inners, root);
+  }
+
+  if(bt->destroy)
+    bt->destroy(old);
+}
+
+unsigned int bt_count(btree_t bt)
+{
+  return bt->count;
+}
+
+void bt_walk(btree_t bt, void (*action)(void *))
+{
+  struct leaf *leaf;
+  unsigned int i;
+
+  for(leaf = first_leaf(bt) ; leaf ; leaf = leaf->next)
+    for(i = 0 ; i < leaf->node.count ; i++)
+      action(leaf->data[i]);
+}
+
+void bt_walk_range(btree_t bt, const void *lo, const void *hi, void (*action)(void *))
+{
+  struct leaf *leaf;
+  unsigned int idx = 0;
+
+  if(lo) {
+    bool found;
+
+    leaf = descend(bt, lo, NULL);
+    idx  = leaf_search(bt, leaf, lo, &found);
+  }
+  else
+    leaf = first_leaf(bt);
+
+  for(; leaf ; leaf = leaf->next, idx = 0) {
+    for(; idx < leaf->node.count ; idx++) {
+      if(hi && bt->compare(leaf->data[idx], hi) >= 0)
+        return;
+      action(leaf->data[idx]);
+    }
+  }
+}
+
+void bt_destroy(btree_t bt)
+{
+  if(bt->destroy)
+    bt_walk(bt, bt->destroy);
+
+  /* the nodes are released slab per slab */
+  slab_destroy(bt->leaves);
+  slab_destroy(bt->inners);
+  free(bt);
+}
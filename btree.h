@@ -0,0 +1,73 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LIBGAWEN_BTREE_H_
+#define _LIBGAWEN_BTREE_H_
+
+typedef struct btree * btree_t;
+
+/* Ordered container implemented as an in-memory B+-tree. Each node holds
+   many data so a search touches a few nodes instead of one node per level
+   of a binary tree. Data are stored in the leaves, which are chained
+   together so that range walks do not go back up the tree.
+
+   The compare and destroy functions are the same as for bst_create().
+   The destroy function may be NULL when there is nothing to destroy. */
+btree_t bt_create(int  (*compare)(const void *, const void *),
+                  void (*destroy)(void *));
+
+/* Insert the data into the tree. If equal data are already present, they
+   are destroyed and replaced. Return the specified data or NULL when it
+   cannot be inserted (out of memory). */
+void * bt_insert(btree_t bt, void *data);
+
+/* Search for data inside the tree. Return the data found or NULL. */
+void * bt_search(btree_t bt, const void *data);
+
+/* Return the first data which is not less than (lower bound) or which is
+   greater than (upper bound) the specified data. Return NULL if there is
+   no such data. */
+void * bt_lower_bound(btree_t bt, const void *data);
+void * bt_upper_bound(btree_t bt, const void *data);
+
+/* Delete the data from the tree. The destroy function passed at creation
+   is used to destroy the data if necessary. */
+void bt_delete(btree_t bt, const void *data);
+
+/* Return the number of data inside the tree. */
+unsigned int bt_count(btree_t bt);
+
+/* In-order walk through the tree and apply the action function on each
+   data. */
+void bt_walk(btree_t bt, void (*action)(void *));
+
+/* In-order walk through the data in the range [lo, hi). When lo is NULL
+   the walk starts from the first data, when hi is NULL it goes up to the
+   last data. */
+void bt_walk_range(btree_t bt, const void *lo, const void *hi, void (*action)(void *));
+
+/* Destroy each data from the tree and then destroy the tree itself. */
+void bt_destroy(btree_t bt);
+
+#endif /* _LIBGAWEN_BTREE_H_ */
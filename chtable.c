@@ -0,0 +1,373 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef __linux__
+# define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "slab.h"
+#include "chtable.h"
+
+#define IDX(hash, size) ((hash) & ((size) - 1))
+
+/* Maximum number of stripes (locks) in a table. */
+#define MAX_STRIPES 64
+
+/* Stripes are padded to avoid false sharing between locks. */
+#define CACHE_LINE 64
+
+struct entry {
+  const void *key;
+  void *data;
+
+  uint32_t hash;
+
+  struct entry *next;
+};
+
+union stripe {
+  struct {
+    pthread_rwlock_t lock;
+    slab_t pool; /* entries of this stripe */
+  } s;
+
+  char pad[CACHE_LINE * ((sizeof(pthread_rwlock_t) + sizeof(slab_t)) / CACHE_LINE + 1)];
+};
+
+struct chtable {
+  uint32_t (*hash)(const void *);
+  bool (*compare)(const void *, const void *);
+  void (*destroy)(void *);
+
+  unsigned int nbuckets;
+  unsigned int nstripes;
+
+  union stripe *stripes;
+  struct entry **buckets;
+};
+
+#define STRIPE(ht, index) (&(ht)->stripes[IDX(index, (ht)->nstripes)].s)
+
+static struct entry * find(const struct chtable *ht, uint32_t hash, const void *key)
+{
+  struct entry *entry;
+
+  for(entry = ht->buckets[IDX(hash, ht->nbuckets)] ; entry ; entry = entry->next)
+    if(entry->hash == hash && ht->compare(entry->key, key))
+      return entry;
+
+  return NULL;
+}
+
+static void * insert_new(struct chtable *ht, uint32_t hash,
+                         const void *key, void *data)
+{
+  uint32_t index     = IDX(hash, ht->nbuckets);
+  struct entry *new  = slab_alloc(STRIPE(ht, index)->pool);
+
+  if(!new)
+    return NULL;
+
+  new->key  = key;
+  new->data = data;
+  new->hash = hash;
+  new->next = ht->buckets[index];
+
+  ht->buckets[index] = new;
+
+  return data;
+}
+
+static void replace(struct chtable *ht, struct entry *entry,
+                    const void *key, void *data)
+{
+  if(ht->destroy)
+    ht->destroy(entry->data);
+
+  entry->key  = key;
+  entry->data = data;
+}
+
+static void cleanup(struct chtable *ht, unsigned int nstripes)
+{
+  unsigned int i;
+
+  for(i = 0 ; i < nstripes ; i++) {
+    pthread_rwlock_destroy(&ht->stripes[i].s.lock);
+    slab_destroy(ht->stripes[i].s.pool);
+  }
+
+  free(ht->stripes);
+  free(ht->buckets);
+  free(ht);
+}
+
+chtable_t cht_create(unsigned int nbuckets,
+                     uint32_t (*hash)(const void *),
+                     bool (*compare)(const void *, const void *),
+                     void (*destroy)(void *))
+{
+  struct chtable *ht = malloc(sizeof(struct chtable));
+  unsigned int size  = 1;
+  unsigned int i;
+  void *stripes;
+
+  if(!ht)
+    return NULL;
+
+  while(size < nbuckets)
+    size <<= 1;
+
+  ht->nbuckets = size;
+  ht->nstripes = size < MAX_STRIPES ? size : MAX_STRIPES;
+
+  ht->hash    = hash;
+  ht->compare = compare;
+  ht->destroy = destroy;
+
+  /* stripes must start on a cache line for the padding to be effective */
+  ht->buckets = calloc(ht->nbuckets, sizeof(struct entry *));
+  ht->stripes = posix_memalign(&stripes, CACHE_LINE, ht->nstripes * sizeof(union stripe)) ? NULL : stripes;
+
+  if(!ht->buckets || !ht->stripes) {
+    cleanup(ht, 0);
+    return NULL;
+  }
+
+  for(i = 0 ; i < ht->nstripes ; i++) {
+    union stripe *stripe = &ht->stripes[i];
+
+    stripe->s.pool = slab_create(sizeof(struct entry), 0);
+
+    if(!stripe->s.pool) {
+      cleanup(ht, i);
+      return NULL;
+    }
+
+    if(pthread_rwlock_init(&stripe->s.lock, NULL)) {
+      slab_destroy(stripe->s.pool);
+      cleanup(ht, i);
+      return NULL;
+    }
+  }
+
+  return ht;
+}
+
+void * cht_search(chtable_t ht, const void *key, void *data)
+{
+  uint32_t hash = ht->hash(key);
+  pthread_rwlock_t *lock = &STRIPE(ht, hash)->lock;
+  struct entry *entry;
+
+  if(data)
+    pthread_rwlock_wrlock(lock);
+  else
+    pthread_rwlock_rdlock(lock);
+
+  entry = find(ht, hash, key);
+
+  if(entry) {
+    if(data)
+      replace(ht, entry, key, data);
+    data = entry->data;
+  }
+  else if(data)
+    data = insert_new(ht, hash, key, data);
+
+  pthread_rwlock_unlock(lock);
+
+  return data;
+}
+
+void * cht_replace(chtable_t ht, const void *key, void *data)
+{
+  uint32_t hash = ht->hash(key);
+  pthread_rwlock_t *lock = &STRIPE(ht, hash)->lock;
+  struct entry *entry;
+
+  if(data)
+    pthread_rwlock_wrlock(lock);
+  else
+    pthread_rwlock_rdlock(lock);
+
+  entry = find(ht, hash, key);
+
+  if(entry) {
+    if(data)
+      replace(ht, entry, key, data);
+    data = entry->data;
+  }
+  else
+    data = NULL;
+
+  pthread_rwlock_unlock(lock);
+
+  return data;
+}
+
+void * cht_insert(chtable_t ht, const void *key, void *data)
+{
+  uint32_t hash = ht->hash(key);
+  pthread_rwlock_t *lock = &STRIPE(ht, hash)->lock;
+  struct entry *entry;
+
+  if(data)
+    pthread_rwlock_wrlock(lock);
+  else
+    pthread_rwlock_rdlock(lock);
+
+  entry = find(ht, hash, key);
+
+  if(entry)
+    data = entry->data;
+  else if(data)
+    data = insert_new(ht, hash, key, data);
+
+  pthread_rwlock_unlock(lock);
+
+  return data;
+}
+
+void * cht_lookup(chtable_t ht, const void *key,
+                  void * (*retrieve)(const void *, void *),
+                  void *optarg)
+{
+  uint32_t hash = ht->hash(key);
+  pthread_rwlock_t *lock = &STRIPE(ht, hash)->lock;
+  struct entry *entry;
+  void *data;
+
+  /* optimistic search with the read lock first */
+  pthread_rwlock_rdlock(lock);
+
+  entry = find(ht, hash, key);
+  if(entry) {
+    data = entry->data;
+    pthread_rwlock_unlock(lock);
+
+    return data;
+  }
+
+  pthread_rwlock_unlock(lock);
+
+  /* another thread may have inserted the key in the meantime */
+  pthread_rwlock_wrlock(lock);
+
+  entry = find(ht, hash, key);
+  if(entry)
+    data = entry->data;
+  else
+    data = insert_new(ht, hash, key, retrieve(key, optarg));
+
+  pthread_rwlock_unlock(lock);
+
+  return data;
+}
+
+void cht_walk(chtable_t ht, void (*action)(void *, void *), void *data)
+{
+  unsigned int s, i;
+
+  for(s = 0 ; s < ht->nstripes ; s++) {
+    pthread_rwlock_t *lock = &ht->stripes[s].s.lock;
+
+    pthread_rwlock_rdlock(lock);
+
+    for(i = s ; i < ht->nbuckets ; i += ht->nstripes) {
+      struct entry *entry;
+
+      for(entry = ht->buckets[i] ; entry ; entry = entry->next)
+        action(entry->data, data);
+    }
+
+    pthread_rwlock_unlock(lock);
+  }
+}
+
+void cht_walk2(chtable_t ht, void (*action)(const void *, void *, void *), void *data)
+{
+  unsigned int s, i;
+
+  for(s = 0 ; s < ht->nstripes ; s++) {
+    pthread_rwlock_t *lock = &ht->stripes[s].s.lock;
+
+    pthread_rwlock_rdlock(lock);
+
+    for(i = s ; i < ht->nbuckets ; i += ht->nstripes) {
+      struct entry *entry;
+
+      for(entry = ht->buckets[i] ; entry ; entry = entry->next)
+        action(entry->key, entry->data, data);
+    }
+
+    pthread_rwlock_unlock(lock);
+  }
+}
+
+void cht_delete(chtable_t ht, const void *key)
+{
+  uint32_t hash = ht->hash(key);
+  uint32_t index = IDX(hash, ht->nbuckets);
+  struct entry **ref;
+  struct entry *entry;
+
+  pthread_rwlock_wrlock(&STRIPE(ht, index)->lock);
+
+  for(ref = &ht->buckets[index] ; *ref ; ref = &(*ref)->next)
+    if((*ref)->hash == hash && ht->compare((*ref)->key, key))
+      break;
+
+  entry = *ref;
+  if(entry) {
+    *ref = entry->next;
+
+    if(ht->destroy)
+      ht->destroy(entry->data);
+    slab_free(STRIPE(ht, index)->pool, entry);
+  }
+
+  pthread_rwlock_unlock(&STRIPE(ht, index)->lock);
+}
+
+void cht_destroy(chtable_t ht)
+{
+  unsigned int i;
+
+  if(ht->destroy) {
+    for(i = 0 ; i < ht->nbuckets ; i++) {
+      struct entry *entry;
+
+      for(entry = ht->buckets[i] ; entry ; entry = entry->next)
+        ht->destroy(entry->data);
+    }
+  }
+
+  cleanup(ht, ht->nstripes);
+}
@@ -0,0 +1,76 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LIBGAWEN_CHTABLE_H_
+#define _LIBGAWEN_CHTABLE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct chtable * chtable_t;
+
+/* Thread safe hash table. Each function cht_xxx() behaves like its ht_xxx()
+   counterpart from htable.h, but may be called concurrently from multiple
+   threads without any external lock.
+
+   The buckets are split into stripes, each protected by its own read/write
+   lock. Searches only take the read lock of the stripe of the key, so they
+   proceed in parallel. Insertions, replacements and deletions take the write
+   lock of this stripe only. Unlike the chained hash table, the number of
+   buckets is fixed at creation so you should size the table accordingly.
+
+   Beware that the data returned by these functions may be destroyed by a
+   concurrent replacement or deletion of the same key. It is up to the caller
+   to ensure that this does not happen while the data is in use. */
+chtable_t cht_create(unsigned int nbuckets,
+                     uint32_t (*hash)(const void *),
+                     bool (*compare)(const void *, const void *),
+                     void (*destroy)(void *));
+
+/* See ht_search(), ht_replace() and ht_insert(). */
+#define cht_insert_or_replace cht_search
+void * cht_search(chtable_t htable, const void *key, void *data);
+void * cht_replace(chtable_t htable, const void *key, void *data);
+void * cht_insert(chtable_t htable, const void *key, void *data);
+
+/* See ht_lookup(). The retrieve function is called at most once per key even
+   when multiple threads lookup the same missing key at the same time. It is
+   called with the write lock of the key stripe held, so it should be quick
+   and must not use the same table. */
+void * cht_lookup(chtable_t htable, const void *key,
+                  void * (*retrieve)(const void *, void *),
+                  void *optarg);
+
+/* See ht_walk() and ht_walk2(). Each stripe is read locked in turn while the
+   action is applied to its entries, so the action must not modify the table. */
+void cht_walk(chtable_t htable, void (*action)(void *, void *), void *data);
+void cht_walk2(chtable_t htable, void (*action)(const void *, void *, void *), void *data);
+
+/* See ht_delete(). */
+void cht_delete(chtable_t htable, const void *key);
+
+/* See ht_destroy(). This function is not thread safe. */
+void cht_destroy(chtable_t htable);
+
+#endif /* _LIBGAWEN_CHTABLE_H_ */
@@ -48,4 +48,13 @@
 # define MAX(x,y) ((x) > (y) ? (x) : (y))
 #endif
 
+#ifndef prefetch
+/* hint the processor to bring data into the cache */
+# ifdef __GNUC__
+#  define prefetch(x) __builtin_prefetch(x)
+# else
+#  define prefetch(x) (void)(x)
+# endif
+#endif
+
 #endif /* _COMMON_H_ */
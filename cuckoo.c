@@ -0,0 +1,467 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef __linux__
+# define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hash.h"
+#include "cuckoo.h"
+
+#define SLOTS 4
+#define MIN_BUCKETS 2
+
+/* Maximum number of buckets examined when searching for a path
+   to an empty slot, and number of times the table may double
+   during a single insertion. */
+#define MAX_BFS   512
+#define MAX_GROWS 4
+
+/* The table only grows when it is at least half full. */
+#define MIN_GROW_LOAD 2
+
+/* Each bucket fills exactly one cache line. */
+#define CACHE_LINE 64
+
+/* A zero hash marks an empty slot. */
+#define NORMALIZE(hash) ((hash) ? (hash) : 1)
+
+/* The data are kept apart so that a lookup only reads the hashes and keys
+   of two buckets, that is two cache lines, and then the data of the entry
+   found. */
+struct bucket {
+  uint32_t    hashes[SLOTS];
+  const void *keys[SLOTS];
+  char pad[CACHE_LINE - SLOTS * (sizeof(uint32_t) + sizeof(void *))];
+};
+
+struct table {
+  unsigned int nbuckets;
+  struct bucket *buckets;
+  void **data; /* data of each slot, SLOTS per bucket */
+};
+
+struct cuckoo {
+  uint32_t (*hash)(const void *);
+  bool (*compare)(const void *, const void *);
+  void (*destroy)(void *);
+
+  unsigned int count;
+  struct table table;
+};
+
+/* step of the breadth first search */
+struct bfs_node {
+  unsigned int bucket;
+  int parent; /* index in the queue, -1 for the roots */
+  int slot;   /* slot of the parent bucket whose entry moves here */
+};
+
+static unsigned int first_bucket(uint32_t hash, unsigned int nbuckets)
+{
+  return hash & (nbuckets - 1);
+}
+
+static unsigned int second_bucket(uint32_t hash, unsigned int nbuckets)
+{
+  return hash_int_jenkins((const void *)(uintptr_t)hash) & (nbuckets - 1);
+}
+
+/* The other bucket where the entry with this hash may be stored. */
+static unsigned int alt_bucket(uint32_t hash, unsigned int bucket, unsigned int nbuckets)
+{
+  unsigned int b1 = first_bucket(hash, nbuckets);
+
+  return bucket == b1 ? second_bucket(hash, nbuckets) : b1;
+}
+
+static bool alloc_table(struct table *table, unsigned int nbuckets)
+{
+  void *buckets;
+
+  if(posix_memalign(&buckets, CACHE_LINE, (size_t)nbuckets * sizeof(struct bucket)))
+    return false;
+
+  table->data = malloc((size_t)nbuckets * SLOTS * sizeof(void *));
+  if(!table->data) {
+    free(buckets);
+    return false;
+  }
+
+  memset(buckets, 0, (size_t)nbuckets * sizeof(struct bucket));
+
+  table->nbuckets = nbuckets;
+  table->buckets  = buckets;
+
+  return true;
+}
+
+static void free_table(struct table *table)
+{
+  free(table->buckets);
+  free(table->data);
+}
+
+static int empty_slot(const struct bucket *bucket)
+{
+  int i;
+
+  for(i = 0 ; i < SLOTS ; i++)
+    if(!bucket->hashes[i])
+      return i;
+
+  return -1;
+}
+
+static bool in_path(const struct bfs_node *queue, int node, unsigned int bucket)
+{
+  for(; node >= 0 ; node = queue[node].parent)
+    if(queue[node].bucket == bucket)
+      return true;
+
+  return false;
+}
+
+static void set_slot(struct table *table, unsigned int bucket, int slot,
+                     uint32_t hash, const void *key, void *data)
+{
+  table->buckets[bucket].hashes[slot] = hash;
+  table->buckets[bucket].keys[slot]   = key;
+  table->data[(size_t)bucket * SLOTS + slot] = data;
+}
+
+/* Place an entry knowing that its key is not present. Return false
+   when no path to an empty slot was found, leaving the table unchanged. */
+static bool place(struct table *table, uint32_t hash, const void *key, void *data)
+{
+  struct bfs_node queue[MAX_BFS];
+  unsigned int nbuckets = table->nbuckets;
+  int head = 0, tail = 0;
+
+  queue[tail++] = (struct bfs_node){ first_bucket(hash, nbuckets), -1, -1 };
+  if(second_bucket(hash, nbuckets) != queue[0].bucket)
+    queue[tail++] = (struct bfs_node){ second_bucket(hash, nbuckets), -1, -1 };
+
+  while(head < tail) {
+    int node = head++;
+    struct bucket *bucket = &table->buckets[queue[node].bucket];
+    int empty = empty_slot(bucket);
+    int i;
+
+    if(empty >= 0) {
+      /* move the entries along the path, from the empty slot to the root */
+      while(queue[node].parent >= 0) {
+        unsigned int from = queue[queue[node].parent].bucket;
+        int slot = queue[node].slot;
+
+        set_slot(table, queue[node].bucket, empty,
+                 table->buckets[from].hashes[slot], table->buckets[from].keys[slot],
+                 table->data[(size_t)from * SLOTS + slot]);
+
+        empty = slot;
+        node  = queue[node].parent;
+      }
+
+      set_slot(table, queue[node].bucket, empty, hash, key, data);
+
+      return true;
+    }
+
+    for(i = 0 ; i < SLOTS && tail < MAX_BFS ; i++) {
+      unsigned int alt = alt_bucket(bucket->hashes[i], queue[node].bucket, nbuckets);
+
+      if(!in_path(queue, node, alt))
+        queue[tail++] = (struct bfs_node){ alt, node, i };
+    }
+  }
+
+  return false;
+}
+
+/* True when both buckets of this hash are full of entries with the same
+   hash. No table size can place one more of them. */
+static bool saturated(const struct cuckoo *ck, uint32_t hash)
+{
+  const struct table *table = &ck->table;
+  unsigned int b1 = first_bucket(hash, table->nbuckets);
+  unsigned int b2 = second_bucket(hash, table->nbuckets);
+  int i;
+
+  /* a larger table may still separate the buckets */
+  if(b1 == b2 && hash_int_jenkins((const void *)(uintptr_t)hash) != hash)
+    return false;
+
+  for(i = 0 ; i < SLOTS ; i++)
+    if(table->buckets[b1].hashes[i] != hash || table->buckets[b2].hashes[i] != hash)
+      return false;
+
+  return true;
+}
+
+/* Rehash the table into a larger one including a new entry. */
+static bool grow(struct cuckoo *ck, uint32_t hash, const void *key, void *data)
+{
+  const struct table *old = &ck->table;
+  unsigned int nbuckets   = old->nbuckets;
+  int attempt;
+
+  /* Below this load the insertion only fails on keys crafted to share
+     their buckets. Growing would not help and costs a full rehash. */
+  if((uint64_t)ck->count * MIN_GROW_LOAD < (uint64_t)old->nbuckets * SLOTS)
+    return false;
+
+  for(attempt = 0 ; attempt < MAX_GROWS ; attempt++) {
+    struct table table;
+    unsigned int i;
+    int j;
+
+    nbuckets <<= 1;
+    if(!nbuckets)
+      return false;
+
+    if(!alloc_table(&table, nbuckets))
+      return false;
+
+    for(i = 0 ; i < old->nbuckets ; i++) {
+      const struct bucket *bucket = &old->buckets[i];
+
+      for(j = 0 ; j < SLOTS ; j++)
+        if(bucket->hashes[j] && !place(&table, bucket->hashes[j], bucket->keys[j],
+                                       old->data[(size_t)i * SLOTS + j]))
+          goto retry;
+    }
+
+    if(!place(&table, hash, key, data))
+      goto retry;
+
+    free_table(&ck->table);
+    ck->table = table;
+
+    return true;
+
+  retry:
+    free_table(&table);
+  }
+
+  return false;
+}
+
+static void * insert_new(struct cuckoo *ck, uint32_t hash, const void *key, void *data)
+{
+  if(place(&ck->table, hash, key, data) ||
+     (!saturated(ck, hash) && grow(ck, hash, key, data))) {
+    ck->count++;
+    return data;
+  }
+
+  return NULL;
+}
+
+/* Return the index of the slot where the key was found, that is the bucket
+   times SLOTS plus the slot inside the bucket, or -1. */
+static long find(const struct cuckoo *ck, uint32_t hash, const void *key)
+{
+  const struct table *table = &ck->table;
+  unsigned int b[2];
+  int i, j;
+
+  b[0] = first_bucket(hash, table->nbuckets);
+  b[1] = second_bucket(hash, table->nbuckets);
+
+  for(i = 0 ; i < 2 ; i++) {
+    const struct bucket *bucket = &table->buckets[b[i]];
+
+    for(j = 0 ; j < SLOTS ; j++)
+      if(bucket->hashes[j] == hash && ck->compare(bucket->keys[j], key))
+        return (long)b[i] * SLOTS + j;
+  }
+
+  return -1;
+}
+
+static void replace(struct cuckoo *ck, long idx, const void *key, void *data)
+{
+  struct table *table = &ck->table;
+
+  if(ck->destroy)
+    ck->destroy(table->data[idx]);
+
+  table->buckets[idx / SLOTS].keys[idx % SLOTS] = key;
+  table->data[idx] = data;
+}
+
+cuckoo_t ck_create(unsigned int nbuckets,
+                   uint32_t (*hash)(const void *),
+                   bool (*compare)(const void *, const void *),
+                   void (*destroy)(void *))
+{
+  struct cuckoo *ck = malloc(sizeof(struct cuckoo));
+  unsigned int size = MIN_BUCKETS;
+
+  if(!ck)
+    return NULL;
+
+  while(size < nbuckets)
+    size <<= 1;
+
+  if(!alloc_table(&ck->table, size)) {
+    free(ck);
+    return NULL;
+  }
+
+  ck->count = 0;
+
+  ck->hash    = hash;
+  ck->compare = compare;
+  ck->destroy = destroy;
+
+  return ck;
+}
+
+void * ck_search(cuckoo_t ck, const void *key, void *data)
+{
+  uint32_t hash = NORMALIZE(ck->hash(key));
+  long idx = find(ck, hash, key);
+
+  if(idx >= 0) {
+    if(data)
+      replace(ck, idx, key, data);
+
+    return ck->table.data[idx];
+  }
+
+  if(data)
+    return insert_new(ck, hash, key, data);
+
+  return NULL;
+}
+
+void * ck_replace(cuckoo_t ck, const void *key, void *data)
+{
+  long idx = find(ck, NORMALIZE(ck->hash(key)), key);
+
+  if(idx < 0)
+    return NULL;
+
+  if(data)
+    replace(ck, idx, key, data);
+
+  return ck->table.data[idx];
+}
+
+void * ck_insert(cuckoo_t ck, const void *key, void *data)
+{
+  uint32_t hash = NORMALIZE(ck->hash(key));
+  long idx = find(ck, hash, key);
+
+  if(idx >= 0)
+    return ck->table.data[idx];
+
+  if(data)
+    return insert_new(ck, hash, key, data);
+
+  return NULL;
+}
+
+void * ck_lookup(cuckoo_t ck, const void *key,
+                 void * (*retrieve)(const void *, void *),
+                 void *optarg)
+{
+  uint32_t hash = NORMALIZE(ck->hash(key));
+  long idx = find(ck, hash, key);
+  void *data;
+
+  if(idx >= 0)
+    return ck->table.data[idx];
+
+  data = retrieve(key, optarg);
+
+  /* the data cannot be returned if it was not inserted */
+  if(data && !insert_new(ck, hash, key, data)) {
+    if(ck->destroy)
+      ck->destroy(data);
+    return NULL;
+  }
+
+  return data;
+}
+
+void ck_walk(cuckoo_t ck, void (*action)(void *, void *), void *data)
+{
+  const struct table *table = &ck->table;
+  unsigned int i;
+  int j;
+
+  for(i = 0 ; i < table->nbuckets ; i++)
+    for(j = 0 ; j < SLOTS ; j++)
+      if(table->buckets[i].hashes[j])
+        action(table->data[(size_t)i * SLOTS + j], data);
+}
+
+void ck_walk2(cuckoo_t ck, void (*action)(const void *, void *, void *), void *data)
+{
+  const struct table *table = &ck->table;
+  unsigned int i;
+  int j;
+
+  for(i = 0 ; i < table->nbuckets ; i++)
+    for(j = 0 ; j < SLOTS ; j++)
+      if(table->buckets[i].hashes[j])
+        action(table->buckets[i].keys[j], table->data[(size_t)i * SLOTS + j], data);
+}
+
+void ck_delete(cuckoo_t ck, const void *key)
+{
+  long idx = find(ck, NORMALIZE(ck->hash(key)), key);
+
+  if(idx < 0)
+    return;
+
+  if(ck->destroy)
+    ck->destroy(ck->table.data[idx]);
+
+  ck->table.buckets[idx / SLOTS].hashes[idx % SLOTS] = 0;
+  ck->count--;
+}
+
+void ck_destroy(cuckoo_t ck)
+{
+  const struct table *table = &ck->table;
+  unsigned int i;
+  int j;
+
+  if(ck->destroy)
+    for(i = 0 ; i < table->nbuckets ; i++)
+      for(j = 0 ; j < SLOTS ; j++)
+        if(table->buckets[i].hashes[j])
+          ck->destroy(table->data[(size_t)i * SLOTS + j]);
+
+  free_table(&ck->table);
+  free(ck);
+}
@@ -0,0 +1,79 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LIBGAWEN_CUCKOO_H_
+#define _LIBGAWEN_CUCKOO_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct cuckoo * cuckoo_t;
+
+/* Bucketized cuckoo hash table. Each function ck_xxx() behaves like its
+   ht_xxx() counterpart from htable.h.
+
+   Each key may only be stored in one of two buckets of four slots. The first
+   bucket is chosen with the hash function of the table, the second one with
+   this hash mixed again by hash_int_jenkins(). A lookup thus never examines
+   more than two buckets whatever the keys, which bounds the worst case
+   latency. Buckets hold the hashes and keys of their entries in a single
+   cache line while the data are stored apart. On insertion, entries are moved to their alternate bucket to make
+   room for the new one (the path is searched breadth first before anything
+   is moved). The table grows when no such path can be found, so the number
+   of buckets is only the initial size of the table.
+
+   As the two buckets are derived from the same 32 bit hash, at most eight
+   keys sharing the same hash can be stored. Insertions return NULL when this
+   limit is reached or when the table cannot grow. The table only grows when
+   it is at least half full, so such insertions fail without rehashing the
+   whole table. Beware that entries are moved inside the table on insertion.
+   So you should not insert or delete entries from within a walk. */
+cuckoo_t ck_create(unsigned int nbuckets,
+                   uint32_t (*hash)(const void *),
+                   bool (*compare)(const void *, const void *),
+                   void (*destroy)(void *));
+
+/* See ht_search(), ht_replace() and ht_insert(). */
+#define ck_insert_or_replace ck_search
+void * ck_search(cuckoo_t htable, const void *key, void *data);
+void * ck_replace(cuckoo_t htable, const void *key, void *data);
+void * ck_insert(cuckoo_t htable, const void *key, void *data);
+
+/* See ht_lookup(). When the retrieved data cannot be inserted, it is freed
+   with the destroy function of the table and NULL is returned. */
+void * ck_lookup(cuckoo_t htable, const void *key,
+                 void * (*retrieve)(const void *, void *),
+                 void *optarg);
+
+/* See ht_walk() and ht_walk2(). */
+void ck_walk(cuckoo_t htable, void (*action)(void *, void *), void *data);
+void ck_walk2(cuckoo_t htable, void (*action)(const void *, void *, void *), void *data);
+
+/* See ht_delete(). */
+void ck_delete(cuckoo_t htable, const void *key);
+
+/* See ht_destroy(). */
+void ck_destroy(cuckoo_t htable);
+
+#endif /* _LIBGAWEN_CUCKOO_H_ */
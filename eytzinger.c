@@ -0,0 +1,204 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef __linux__
+# define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common.h"
+#include "bst.h"
+#include "eytzinger.h"
+
+#define CACHE_LINE 64
+
+/* Children of the node k are 2k and 2k + 1. So the descendants of k four
+   levels below are the 16 consecutive nodes from 16k. As the array is
+   aligned on a cache line, these nodes fill exactly two cache lines of
+   64-bit pointers and both are prefetched. */
+#define PREFETCH_STRIDE 16
+#define PREFETCH_NODES  (CACHE_LINE / sizeof(void *))
+
+struct eytzinger {
+  int (*compare)(const void *, const void *);
+
+  unsigned int n;
+  void **data; /* n + 1 data, the first one is not used */
+};
+
+/* Place the sorted data in the subtree rooted at k with an in-order walk of
+   the implicit tree. Return the index of the next sorted data. The depth of
+   the recursion is the height of the tree. */
+static unsigned int fill(struct eytzinger *eyt, void **sorted, unsigned int i, unsigned int k)
+{
+  if(k > eyt->n)
+    return i;
+
+  i = fill(eyt, sorted, i, 2 * k);
+  eyt->data[k] = sorted[i++];
+
+  return fill(eyt, sorted, i, 2 * k + 1);
+}
+
+eytzinger_t eyt_build(int (*compare)(const void *, const void *),
+                      void **data, unsigned int n)
+{
+  struct eytzinger *eyt = malloc(sizeof(struct eytzinger));
+  void *array;
+
+  if(!eyt)
+    return NULL;
+
+  if(posix_memalign(&array, CACHE_LINE, ((size_t)n + 1) * sizeof(void *))) {
+    free(eyt);
+    return NULL;
+  }
+
+  eyt->data    = array;
+  eyt->compare = compare;
+  eyt->n       = n;
+  eyt->data[0] = NULL;
+
+  fill(eyt, data, 0, 1);
+
+  return eyt;
+}
+
+eytzinger_t eyt_build_bst(int (*compare)(const void *, const void *), bst_t bst)
+{
+  unsigned int i, n = bst_count(bst);
+  struct bst_iter iter;
+  eytzinger_t eyt;
+  void **sorted;
+
+  if(!n)
+    return eyt_build(compare, NULL, 0);
+
+  sorted = malloc(n * sizeof(void *));
+  if(!sorted)
+    return NULL;
+
+  bst_iter_init(bst, &iter);
+  for(i = 0 ; i < n ; i++)
+    bst_iter_next(&iter, &sorted[i]);
+
+  eyt = eyt_build(compare, sorted, n);
+  free(sorted);
+
+  return eyt;
+}
+
+/* The index of the lower bound is found by removing the right turns taken
+   after the last left turn, that is the trailing ones, and this left turn. */
+static unsigned int last_left(unsigned int k)
+{
+#ifdef __GNUC__
+  return k >> __builtin_ffs(~k);
+#else
+  while(k & 1)
+    k >>= 1;
+  return k >> 1;
+#endif
+}
+
+/* Prefetch the descendants of the node k four levels below. Addresses
+   past the end of the array are only hints and never dereferenced. */
+static void prefetch_descendants(const struct eytzinger *eyt, unsigned int k)
+{
+  void **nodes = &eyt->data[(size_t)PREFETCH_STRIDE * k];
+
+  prefetch(nodes);
+  if(PREFETCH_NODES < PREFETCH_STRIDE)
+    prefetch(nodes + PREFETCH_NODES);
+}
+
+/* The loops are branchless: the comparison only selects the child. */
+static unsigned int lower_bound(const struct eytzinger *eyt, const void *data)
+{
+  unsigned int k = 1;
+
+  if(eyt->compare) {
+    while(k <= eyt->n) {
+      prefetch_descendants(eyt, k);
+      k = 2 * k + (eyt->compare(data, eyt->data[k]) > 0);
+    }
+  }
+  else {
+    uintptr_t key = (uintptr_t)data;
+
+    while(k <= eyt->n) {
+      prefetch_descendants(eyt, k);
+      k = 2 * k + (key > (uintptr_t)eyt->data[k]);
+    }
+  }
+
+  return last_left(k);
+}
+
+void * eyt_lower_bound(eytzinger_t eyt, const void *data)
+{
+  unsigned int k = lower_bound(eyt, data);
+
+  return k ? eyt->data[k] : NULL;
+}
+
+/* Return the index of the data equal to the specified data or zero. */
+static unsigned int search(const struct eytzinger *eyt, const void *data)
+{
+  unsigned int k = lower_bound(eyt, data);
+
+  if(!k)
+    return 0;
+
+  if(eyt->compare)
+    return eyt->compare(data, eyt->data[k]) ? 0 : k;
+  else
+    return data == eyt->data[k] ? k : 0;
+}
+
+void * eyt_search(eytzinger_t eyt, const void *data)
+{
+  unsigned int k = search(eyt, data);
+
+  return k ? eyt->data[k] : NULL;
+}
+
+bool eyt_contains(eytzinger_t eyt, const void *data)
+{
+  return search(eyt, data) != 0;
+}
+
+unsigned int eyt_count(eytzinger_t eyt)
+{
+  return eyt->n;
+}
+
+void eyt_destroy(eytzinger_t eyt)
+{
+  free(eyt->data);
+  free(eyt);
+}
@@ -0,0 +1,72 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LIBGAWEN_EYTZINGER_H_
+#define _LIBGAWEN_EYTZINGER_H_
+
+#include <stdbool.h>
+
+#include "bst.h"
+
+typedef struct eytzinger * eytzinger_t;
+
+/* Frozen sorted set for read-mostly data. The data are stored in a single
+   array in Eytzinger order, that is the order of a breadth-first walk of a
+   balanced binary search tree. The first levels of the tree share the same
+   cache lines and a search prefetches the nodes four levels below without
+   depending on the result of the comparisons. This is generally faster than
+   a binary search on a sorted array or a search in a bst.
+
+   The compare function is the same as for bst_create(). When it is NULL,
+   the data are integers stored inside the pointers and compared as such.
+   The integer 0 is then returned as NULL by eyt_search() and
+   eyt_lower_bound(), use eyt_contains() to know whether it is present.
+   The data are neither copied nor destroyed. */
+
+/* Build the array from n data sorted in ascending order without duplicates.
+   Return NULL on allocation failure. */
+eytzinger_t eyt_build(int (*compare)(const void *, const void *),
+                      void **data, unsigned int n);
+
+/* Build the array from the data of a binary sort tree. The compare function
+   should be the one of the tree. */
+eytzinger_t eyt_build_bst(int (*compare)(const void *, const void *), bst_t bst);
+
+/* Return the data equal to the specified data or NULL if there is none. */
+void * eyt_search(eytzinger_t eyt, const void *data);
+
+/* Return true if the array contains data equal to the specified data. */
+bool eyt_contains(eytzinger_t eyt, const void *data);
+
+/* Return the first data which is not less than the specified data or NULL
+   if there is none. */
+void * eyt_lower_bound(eytzinger_t eyt, const void *data);
+
+/* Return the number of data inside the array. */
+unsigned int eyt_count(eytzinger_t eyt);
+
+/* Destroy the array but not the data. */
+void eyt_destroy(eytzinger_t eyt);
+
+#endif /* _LIBGAWEN_EYTZINGER_H_ */
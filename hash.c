@@ -22,9 +22,77 @@
    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#if defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__) || defined(__APPLE__)
+# define HAVE_ARC4RANDOM
+#endif
+
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "crc32.h"
+#include "hash.h"
+
+/* Multiply two 64-bit words to 128 bits and return both halves. */
+#ifdef __SIZEOF_INT128__
+__extension__ typedef unsigned __int128 uint128_t;
+
+static void mum(uint64_t *a, uint64_t *b)
+{
+  uint128_t r = (uint128_t)*a * *b;
+
+  *a = (uint64_t)r;
+  *b = (uint64_t)(r >> 64);
+}
+#else
+static void mum(uint64_t *a, uint64_t *b)
+{
+  uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+  uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  uint64_t t  = rl + (rm0 << 32);
+  uint64_t c  = t < rl;
+  uint64_t lo = t + (rm1 << 32);
+
+  c += lo < t;
+  *a = lo;
+  *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+}
+#endif
+
+static uint64_t mix(uint64_t a, uint64_t b)
+{
+  mum(&a, &b);
+  return a ^ b;
+}
+
+/* wyhash secret */
+#define WY0 0x2d358dccaa6c78a5ULL
+#define WY1 0x8bb84b93962eacc9ULL
+#define WY2 0x4b33a62ed433d4a3ULL
+#define WY3 0x4d5a2da51de1aa47ULL
+
+/* SipHash-1-3 rounds */
+#define C_ROUNDS 1
+#define D_ROUNDS 3
+
+#define ROTL(x, b, bits) (((x) << (b)) | ((x) >> ((bits) - (b))))
+
+#define SIPROUND(v0, v1, v2, v3) do {                          \
+    v0 += v1; v1 = ROTL(v1, 13, 64); v1 ^= v0; v0 = ROTL(v0, 32, 64); \
+    v2 += v3; v3 = ROTL(v3, 16, 64); v3 ^= v2;                 \
+    v0 += v3; v3 = ROTL(v3, 21, 64); v3 ^= v0;                 \
+    v2 += v1; v1 = ROTL(v1, 17, 64); v1 ^= v2; v2 = ROTL(v2, 32, 64); \
+  } while(0)
+
+#define HALFSIPROUND(v0, v1, v2, v3) do {                      \
+    v0 += v1; v1 = ROTL(v1, 5, 32);  v1 ^= v0; v0 = ROTL(v0, 16, 32); \
+    v2 += v3; v3 = ROTL(v3, 8, 32);  v3 ^= v2;                 \
+    v0 += v3; v3 = ROTL(v3, 7, 32);  v3 ^= v0;                 \
+    v2 += v1; v1 = ROTL(v1, 13, 32); v1 ^= v2; v2 = ROTL(v2, 16, 32); \
+  } while(0)
 
 bool htable_str_cmp(const void *k1, const void *k2)
 {
@@ -185,3 +253,571 @@ uint32_t hash_int_knuth(const void *key)
 
   return hash;
 }
+
+
+
+/* Little endian loads that do not depend on the alignment. */
+static uint64_t load64_le(const unsigned char *p)
+{
+  return (uint64_t)p[0]       | (uint64_t)p[1] << 8  |
+         (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24 |
+         (uint64_t)p[4] << 32 | (uint64_t)p[5] << 40 |
+         (uint64_t)p[6] << 48 | (uint64_t)p[7] << 56;
+}
+
+static uint32_t load32_le(const unsigned char *p)
+{
+  return (uint32_t)p[0]       | (uint32_t)p[1] << 8 |
+         (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+/* Host order loads used by wyhash. */
+static uint64_t read64(const unsigned char *p)
+{
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static uint64_t read32(const unsigned char *p)
+{
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+/* Read keys of at most 16 bytes into two words. */
+static void read_short(const unsigned char *p, size_t len, uint64_t *a, uint64_t *b)
+{
+  if(len >= 4) {
+    size_t half = (len >> 3) << 2;
+
+    *a = (read32(p) << 32) | read32(p + half);
+    *b = (read32(p + len - 4) << 32) | read32(p + len - 4 - half);
+  }
+  else if(len > 0) {
+    *a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+    *b = 0;
+  }
+  else
+    *a = *b = 0;
+}
+
+/* wyhash by Wang Yi */
+uint64_t hash_buf_wy(const void *buf, size_t len, uint64_t seed)
+{
+  const unsigned char *p = buf;
+  size_t i = len;
+  uint64_t a, b;
+
+  seed ^= mix(seed ^ WY0, WY1);
+
+  if(len <= 16)
+    read_short(p, len, &a, &b);
+  else {
+    /* three independent lanes on long keys */
+    if(i > 48) {
+      uint64_t see1 = seed, see2 = seed;
+
+      do {
+        seed = mix(read64(p) ^ WY1, read64(p + 8) ^ seed);
+        see1 = mix(read64(p + 16) ^ WY2, read64(p + 24) ^ see1);
+        see2 = mix(read64(p + 32) ^ WY3, read64(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while(i > 48);
+
+      seed ^= see1 ^ see2;
+    }
+
+    for(; i > 16 ; i -= 16, p += 16)
+      seed = mix(read64(p) ^ WY1, read64(p + 8) ^ seed);
+
+    a = read64(p + i - 16);
+    b = read64(p + i - 8);
+  }
+
+  a ^= WY1;
+  b ^= seed;
+  mum(&a, &b);
+
+  return mix(a ^ WY0 ^ len, b ^ WY1);
+}
+
+/* XXH3-128 by Yann Collet, the scalar version with the default secret.
+   Keys up to 240 bytes are mixed with the secret and the seed directly.
+   Longer keys go through eight accumulators with a secret derived from
+   the seed. */
+#define P32_1 0x9e3779b1U
+#define P32_2 0x85ebca77U
+#define P32_3 0xc2b2ae3dU
+#define P64_1 0x9e3779b185ebca87ULL
+#define P64_2 0xc2b2ae3d27d4eb4fULL
+#define P64_3 0x165667b19e3779f9ULL
+#define P64_4 0x85ebca77c2b2ae63ULL
+#define P64_5 0x27d4eb2f165667c5ULL
+
+#define XXH_SECRET_SIZE 192
+#define XXH_STRIPE      64
+#define XXH_MID_MAX     240
+
+static const unsigned char xxh_secret[XXH_SECRET_SIZE] = {
+  0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+  0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+  0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+  0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+  0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+  0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+  0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+  0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+  0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+  0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+  0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+  0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+};
+
+static uint64_t xxh64_avalanche(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= P64_2;
+  h ^= h >> 29;
+  h *= P64_3;
+  return h ^ (h >> 32);
+}
+
+static uint64_t xxh3_avalanche(uint64_t h)
+{
+  h ^= h >> 37;
+  h *= 0x165667919e3779f9ULL;
+  return h ^ (h >> 32);
+}
+
+static uint64_t mix16(const unsigned char *p, const unsigned char *s, uint64_t seed)
+{
+  return mix(read64(p) ^ (read64(s) + seed), read64(p + 8) ^ (read64(s + 8) - seed));
+}
+
+static void mix32(uint64_t *acc, const unsigned char *p, const unsigned char *q,
+                  const unsigned char *s, uint64_t seed)
+{
+  acc[0] += mix16(p, s, seed);
+  acc[0] ^= read64(q) + read64(q + 8);
+  acc[1] += mix16(q, s + 16, seed);
+  acc[1] ^= read64(p) + read64(p + 8);
+}
+
+static void xxh128_short(const unsigned char *p, size_t len, uint64_t seed, uint64_t *out)
+{
+  const unsigned char *s = xxh_secret;
+
+  if(len > 8) {
+    uint64_t flip_lo = (read64(s + 32) ^ read64(s + 40)) - seed;
+    uint64_t flip_hi = (read64(s + 48) ^ read64(s + 56)) + seed;
+    uint64_t lo = read64(p) ^ read64(p + len - 8) ^ flip_lo;
+    uint64_t hi = read64(p + len - 8) ^ flip_hi;
+    uint64_t m  = P64_1;
+
+    mum(&lo, &m);
+    lo += (uint64_t)(len - 1) << 54;
+    m  += hi + (uint32_t)hi * (uint64_t)(P32_2 - 1);
+    lo ^= __builtin_bswap64(m);
+    hi  = P64_2;
+    mum(&lo, &hi);
+    hi += m * P64_2;
+
+    out[0] = xxh3_avalanche(lo);
+    out[1] = xxh3_avalanche(hi);
+  }
+  else if(len >= 4) {
+    uint64_t lo, hi;
+
+    seed ^= (uint64_t)__builtin_bswap32((uint32_t)seed) << 32;
+    lo = (read32(p) + (read32(p + len - 4) << 32)) ^ ((read64(s + 16) ^ read64(s + 24)) + seed);
+    hi = P64_1 + (len << 2);
+    mum(&lo, &hi);
+    hi += lo << 1;
+    lo ^= hi >> 3;
+    lo ^= lo >> 35;
+    lo *= 0x9fb21c651e98df25ULL;
+    lo ^= lo >> 28;
+
+    out[0] = lo;
+    out[1] = xxh3_avalanche(hi);
+  }
+  else if(len > 0) {
+    uint32_t lo = ((uint32_t)p[0] << 16) | ((uint32_t)p[len >> 1] << 24) | p[len - 1] | ((uint32_t)len << 8);
+    uint32_t hi = __builtin_bswap32(lo);
+
+    hi = (hi << 13) | (hi >> 19);
+    out[0] = xxh64_avalanche(lo ^ ((read32(s) ^ read32(s + 4)) + seed));
+    out[1] = xxh64_avalanche(hi ^ ((read32(s + 8) ^ read32(s + 12)) - seed));
+  }
+  else {
+    out[0] = xxh64_avalanche(seed ^ read64(s + 64) ^ read64(s + 72));
+    out[1] = xxh64_avalanche(seed ^ read64(s + 80) ^ read64(s + 88));
+  }
+}
+
+static void xxh128_mid(const unsigned char *p, size_t len, uint64_t seed, uint64_t *out)
+{
+  const unsigned char *s = xxh_secret;
+  uint64_t acc[2] = { len * P64_1, 0 };
+
+  if(len <= 128) {
+    if(len > 32) {
+      if(len > 64) {
+        if(len > 96)
+          mix32(acc, p + 48, p + len - 64, s + 96, seed);
+        mix32(acc, p + 32, p + len - 48, s + 64, seed);
+      }
+      mix32(acc, p + 16, p + len - 32, s + 32, seed);
+    }
+    mix32(acc, p, p + len - 16, s, seed);
+  }
+  else {
+    size_t i, rounds = len / 32;
+
+    for(i = 0 ; i < 4 ; i++)
+      mix32(acc, p + 32 * i, p + 32 * i + 16, s + 32 * i, seed);
+
+    acc[0] = xxh3_avalanche(acc[0]);
+    acc[1] = xxh3_avalanche(acc[1]);
+
+    for(; i < rounds ; i++)
+      mix32(acc, p + 32 * i, p + 32 * i + 16, s + 3 + 32 * (i - 4), seed);
+
+    mix32(acc, p + len - 16, p + len - 32, s + 136 - 17 - 16, -seed);
+  }
+
+  out[0] = xxh3_avalanche(acc[0] + acc[1]);
+  out[1] = -xxh3_avalanche(acc[0] * P64_1 + acc[1] * P64_4 + (len - seed) * P64_2);
+}
+
+static void accumulate(uint64_t *acc, const unsigned char *p, const unsigned char *s)
+{
+  int i;
+
+  for(i = 0 ; i < 8 ; i++) {
+    uint64_t v = read64(p + 8 * i);
+    uint64_t k = v ^ read64(s + 8 * i);
+
+    acc[i ^ 1] += v;
+    acc[i]     += (uint32_t)k * (k >> 32);
+  }
+}
+
+static void scramble(uint64_t *acc, const unsigned char *s)
+{
+  int i;
+
+  for(i = 0 ; i < 8 ; i++) {
+    uint64_t a = acc[i];
+
+    a ^= a >> 47;
+    a ^= read64(s + 8 * i);
+    acc[i] = a * P32_1;
+  }
+}
+
+static uint64_t merge(const uint64_t *acc, const unsigned char *s, uint64_t h)
+{
+  int i;
+
+  for(i = 0 ; i < 4 ; i++)
+    h += mix(acc[2 * i] ^ read64(s + 16 * i), acc[2 * i + 1] ^ read64(s + 16 * i + 8));
+
+  return xxh3_avalanche(h);
+}
+
+static void xxh128_long(const unsigned char *p, size_t len, uint64_t seed, uint64_t *out)
+{
+  uint64_t acc[8] = { P32_3, P64_1, P64_2, P64_3, P64_4, P32_2, P64_5, P32_1 };
+  unsigned char derived[XXH_SECRET_SIZE];
+  const unsigned char *s = xxh_secret;
+  size_t stripes = (XXH_SECRET_SIZE - XXH_STRIPE) / 8;
+  size_t block   = XXH_STRIPE * stripes;
+  size_t blocks  = (len - 1) / block;
+  size_t i, j;
+
+  if(seed) {
+    for(i = 0 ; i < XXH_SECRET_SIZE ; i += 16) {
+      uint64_t lo = read64(xxh_secret + i) + seed;
+      uint64_t hi = read64(xxh_secret + i + 8) - seed;
+
+      memcpy(derived + i, &lo, sizeof(lo));
+      memcpy(derived + i + 8, &hi, sizeof(hi));
+    }
+    s = derived;
+  }
+
+  for(i = 0 ; i < blocks ; i++) {
+    for(j = 0 ; j < stripes ; j++)
+      accumulate(acc, p + i * block + j * XXH_STRIPE, s + j * 8);
+    scramble(acc, s + XXH_SECRET_SIZE - XXH_STRIPE);
+  }
+
+  stripes = (len - 1 - block * blocks) / XXH_STRIPE;
+  for(j = 0 ; j < stripes ; j++)
+    accumulate(acc, p + blocks * block + j * XXH_STRIPE, s + j * 8);
+  accumulate(acc, p + len - XXH_STRIPE, s + XXH_SECRET_SIZE - XXH_STRIPE - 7);
+
+  out[0] = merge(acc, s + 11, len * P64_1);
+  out[1] = merge(acc, s + XXH_SECRET_SIZE - 64 - 11, ~(len * P64_2));
+}
+
+void hash_buf_xxh128(const void *buf, size_t len, uint64_t seed, uint64_t *out)
+{
+  if(len <= 16)
+    xxh128_short(buf, len, seed, out);
+  else if(len <= XXH_MID_MAX)
+    xxh128_mid(buf, len, seed, out);
+  else
+    xxh128_long(buf, len, seed, out);
+}
+
+uint32_t hash_str_wy(const void *key)
+{
+  return hash_buf_wy(key, strlen(key), 0);
+}
+
+uint32_t hash_str_wy_seeded(const void *key, const void *seed)
+{
+  return hash_buf_wy(key, strlen(key), read64(seed));
+}
+
+/* CRC32C steps. With SSE 4.2 on x86-64 we use the crc32 instruction
+   directly as in crc32_intel(). Otherwise we fall back to crc32_c() on
+   the same bytes, so both give the same results. */
+#if defined(__SSE4_2__) && defined(__x86_64__)
+static uint32_t crc_u64(uint32_t crc, uint64_t v)
+{
+  uint64_t c = crc;
+
+  __asm__("crc32q %[v], %[c]"
+          : [c] "=r" (c)
+          : "[c]" (c), [v] "r" (v));
+
+  return c;
+}
+
+static uint32_t crc_u32(uint32_t crc, uint32_t v)
+{
+  __asm__("crc32l %[v], %[crc]"
+          : [crc] "=r" (crc)
+          : "[crc]" (crc), [v] "r" (v));
+
+  return crc;
+}
+
+static uint32_t crc_u8(uint32_t crc, unsigned char v)
+{
+  __asm__("crc32b %[v], %[crc]"
+          : [crc] "=r" (crc)
+          : "[crc]" (crc), [v] "r" (v));
+
+  return crc;
+}
+#else /* generic */
+static uint32_t crc_u64(uint32_t crc, uint64_t v)
+{
+  return crc32_c((const unsigned char *)&v, sizeof(v), crc);
+}
+
+static uint32_t crc_u32(uint32_t crc, uint32_t v)
+{
+  return crc32_c((const unsigned char *)&v, sizeof(v), crc);
+}
+
+static uint32_t crc_u8(uint32_t crc, unsigned char v)
+{
+  return crc32_c(&v, 1, crc);
+}
+#endif
+
+/* Keys at least this long are hashed with three interleaved CRC streams.
+   The crc32 instruction has a latency of three cycles but can start on
+   each cycle, so this keeps it busy. */
+#define CRC_STREAMS_MIN 64
+
+/* MurmurHash3 finalizer, CRC alone does not avalanche. */
+static uint32_t fmix32(uint32_t h)
+{
+  h ^= h >> 16;
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35;
+  h ^= h >> 16;
+
+  return h;
+}
+
+uint32_t hash_buf_crc32c(const void *buf, size_t len, uint32_t seed)
+{
+  const unsigned char *p = buf;
+  size_t n   = len;
+  uint32_t c0 = seed;
+
+  if(n >= CRC_STREAMS_MIN) {
+    uint32_t c1 = seed ^ 0x9e3779b9;
+    uint32_t c2 = seed ^ 0x7f4a7c15;
+
+    do {
+      c0 = crc_u64(c0, read64(p));
+      c1 = crc_u64(c1, read64(p + 8));
+      c2 = crc_u64(c2, read64(p + 16));
+      p += 24;
+      n -= 24;
+    } while(n >= 24);
+
+    /* Streams are combined with the CRC itself rather than with a xor,
+       otherwise swapping the words of two streams would not change the
+       result. */
+    c0 = crc_u32(c0, c1);
+    c0 = crc_u32(c0, c2);
+  }
+
+  for(; n >= 8 ; n -= 8, p += 8)
+    c0 = crc_u64(c0, read64(p));
+
+  while(n--)
+    c0 = crc_u8(c0, *p++);
+
+  return fmix32(c0 ^ len);
+}
+
+uint32_t hash_str_crc32c(const void *key)
+{
+  return hash_buf_crc32c(key, strlen(key), 0);
+}
+
+uint32_t hash_int_crc32c(const void *key)
+{
+  return fmix32(crc_u64(0, (uintptr_t)key));
+}
+
+/* SipHash-1-3 by Jean-Philippe Aumasson and Daniel J. Bernstein */
+uint64_t hash_buf_siphash(const void *buf, size_t len, const void *seed)
+{
+  const unsigned char *in  = buf;
+  const unsigned char *end = in + (len & ~7);
+  uint64_t k0 = load64_le(seed);
+  uint64_t k1 = load64_le((const unsigned char *)seed + 8);
+  uint64_t v0 = 0x736f6d6570736575ULL ^ k0;
+  uint64_t v1 = 0x646f72616e646f6dULL ^ k1;
+  uint64_t v2 = 0x6c7967656e657261ULL ^ k0;
+  uint64_t v3 = 0x7465646279746573ULL ^ k1;
+  uint64_t b  = (uint64_t)len << 56;
+  uint64_t m;
+  int i;
+
+  for(; in != end ; in += 8) {
+    m   = load64_le(in);
+    v3 ^= m;
+    for(i = 0 ; i < C_ROUNDS ; i++)
+      SIPROUND(v0, v1, v2, v3);
+    v0 ^= m;
+  }
+
+  switch(len & 7) {
+  case 7: b |= (uint64_t)in[6] << 48; /* fall through */
+  case 6: b |= (uint64_t)in[5] << 40; /* fall through */
+  case 5: b |= (uint64_t)in[4] << 32; /* fall through */
+  case 4: b |= (uint64_t)in[3] << 24; /* fall through */
+  case 3: b |= (uint64_t)in[2] << 16; /* fall through */
+  case 2: b |= (uint64_t)in[1] << 8;  /* fall through */
+  case 1: b |= (uint64_t)in[0];
+  }
+
+  v3 ^= b;
+  for(i = 0 ; i < C_ROUNDS ; i++)
+    SIPROUND(v0, v1, v2, v3);
+  v0 ^= b;
+
+  v2 ^= 0xff;
+  for(i = 0 ; i < D_ROUNDS ; i++)
+    SIPROUND(v0, v1, v2, v3);
+
+  return v0 ^ v1 ^ v2 ^ v3;
+}
+
+/* HalfSipHash-1-3 by Jean-Philippe Aumasson */
+uint32_t hash_buf_halfsiphash(const void *buf, size_t len, const void *seed)
+{
+  const unsigned char *in  = buf;
+  const unsigned char *end = in + (len & ~3);
+  uint32_t k0 = load32_le(seed);
+  uint32_t k1 = load32_le((const unsigned char *)seed + 4);
+  uint32_t v0 = k0;
+  uint32_t v1 = k1;
+  uint32_t v2 = 0x6c796765 ^ k0;
+  uint32_t v3 = 0x74656462 ^ k1;
+  uint32_t b  = (uint32_t)len << 24;
+  uint32_t m;
+  int i;
+
+  for(; in != end ; in += 4) {
+    m   = load32_le(in);
+    v3 ^= m;
+    for(i = 0 ; i < C_ROUNDS ; i++)
+      HALFSIPROUND(v0, v1, v2, v3);
+    v0 ^= m;
+  }
+
+  switch(len & 3) {
+  case 3: b |= (uint32_t)in[2] << 16; /* fall through */
+  case 2: b |= (uint32_t)in[1] << 8;  /* fall through */
+  case 1: b |= (uint32_t)in[0];
+  }
+
+  v3 ^= b;
+  for(i = 0 ; i < C_ROUNDS ; i++)
+    HALFSIPROUND(v0, v1, v2, v3);
+  v0 ^= b;
+
+  v2 ^= 0xff;
+  for(i = 0 ; i < D_ROUNDS ; i++)
+    HALFSIPROUND(v0, v1, v2, v3);
+
+  return v1 ^ v3;
+}
+
+uint32_t hash_str_siphash(const void *key, const void *seed)
+{
+  return hash_buf_siphash(key, strlen(key), seed);
+}
+
+uint32_t hash_str_halfsiphash(const void *key, const void *seed)
+{
+  return hash_buf_halfsiphash(key, strlen(key), seed);
+}
+
+void hash_seed(void *seed, size_t size)
+{
+#ifdef HAVE_ARC4RANDOM
+  arc4random_buf(seed, size);
+#else
+  unsigned char *p = seed;
+  FILE *urandom = fopen("/dev/urandom", "rb");
+  size_t n = 0;
+
+  if(urandom) {
+    n = fread(seed, 1, size, urandom);
+    fclose(urandom);
+  }
+
+  /* Without a random source, we can only mix a few values that are hard
+     to predict from the outside. This is better than a constant seed. */
+  if(n != size) {
+    uint32_t h = hash_int_jenkins((void *)(uintptr_t)time(NULL));
+
+    h ^= hash_int_jenkins((void *)(uintptr_t)clock());
+    h ^= hash_int_jenkins((void *)(uintptr_t)&h);
+    h ^= hash_int_jenkins(seed);
+
+    for(n = 0 ; n < size ; n++) {
+      h = hash_int_jenkins((void *)(uintptr_t)(h + n));
+      p[n] ^= h;
+    }
+  }
+#endif
+}
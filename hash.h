@@ -25,6 +25,8 @@
 #ifndef _HASH_
 #define _HASH_
 
+#include <stddef.h>
+
 /* key comparison */
 bool htable_str_cmp(const void *k1, const void *k2);
 bool htable_int_cmp(const void *k1, const void *k2);
@@ -37,10 +39,44 @@ uint32_t hash_str_elf(const void *key);     /* ELF hash */
 uint32_t hash_str_knuth(const void *key);   /* Knuth's hash */
 uint32_t hash_str_jenkins(const void *key); /* Robert Jenkins's sring hash */
 uint32_t hash_str_kr(const void *key);      /* K&R lose lose hash (if you don't know, probably not this one) */
+uint32_t hash_str_crc32c(const void *key);  /* CRC32C with a final mix (fast with SSE 4.2) */
 
 /* integer */
 uint32_t hash_int_jenkins(const void *key);  /* Robert Jenkins's integer hash (if you don't know, probably this one) */
 uint32_t hash_int_jacobson(const void *key); /* Van Jacobson's IPv4 hash */
 uint32_t hash_int_knuth(const void *key);    /* Knuth's multiplicative hash (if you don't know, probably not this one) */
+uint32_t hash_int_crc32c(const void *key);   /* CRC32C with a final mix (fast with SSE 4.2) */
+
+/* buffers
+   Those hashes process whole words and are much faster than the string
+   hashes above on long keys. They also accept binary keys. The result
+   depends on the byte order of the host. Use HASH_BUF_WY() to declare
+   a hash function for keys of fixed size (structures, UUIDs, ...) that
+   can be used with ht_create(). */
+uint64_t hash_buf_wy(const void *buf, size_t len, uint64_t seed);                  /* wyhash (final version 4) */
+void     hash_buf_xxh128(const void *buf, size_t len, uint64_t seed, uint64_t *out); /* XXH3-128 (low and high words in out) */
+uint32_t hash_buf_crc32c(const void *buf, size_t len, uint32_t seed);            /* CRC32C with a final mix (fast with SSE 4.2) */
+uint32_t hash_str_wy(const void *key);                     /* wyhash on strings */
+uint32_t hash_str_wy_seeded(const void *key, const void *seed); /* keyed with ht_create_seeded() but not hash-flooding resistant */
+
+#define HASH_BUF_WY(name, size)                                   \
+  static uint32_t name(const void *key)                           \
+  {                                                               \
+    return hash_buf_wy(key, size, 0);                             \
+  }
+
+/* keyed
+   Those hashes depend on a secret seed so that an attacker cannot craft keys
+   that collide in a hashtable. The seed is HASH_SEED_SIZE bytes long. The
+   string variants may be used with ht_create_seeded(). */
+#define HASH_SEED_SIZE 16
+
+uint64_t hash_buf_siphash(const void *buf, size_t len, const void *seed);     /* SipHash-1-3 */
+uint32_t hash_buf_halfsiphash(const void *buf, size_t len, const void *seed); /* HalfSipHash-1-3 (only use 8 bytes of the seed) */
+uint32_t hash_str_siphash(const void *key, const void *seed);     /* SipHash-1-3 (if you don't know, probably this one) */
+uint32_t hash_str_halfsiphash(const void *key, const void *seed); /* HalfSipHash-1-3 (faster on 32-bit architectures) */
+
+/* Fill the seed with random bytes from the system. */
+void hash_seed(void *seed, size_t size);
 
 #endif /* _HASH_ */
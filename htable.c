@@ -27,40 +27,252 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "common.h"
+#include "slab.h"
+#include "hash.h"
 #include "htable.h"
 
-#define IDX(hash, size) hash & (size - 1)
+#define IDX(hash, size) ((hash) & ((size) - 1))
+
+/* Number of non-empty buckets migrated on each operation while the table
+   is resized. Empty buckets are skipped over but we visit at most
+   REHASH_EMPTY_VISITS of them per migrated bucket in a single step. */
+#define REHASH_STEP         1
+#define REHASH_EMPTY_VISITS 10
+
+/* Grow when the load factor goes over this value and shrink when it goes
+   under the inverse of this value. */
+#define GROW_LOAD   1
+#define SHRINK_LOAD 8
+
+/* Number of keys processed together by ht_search_batch(). */
+#define BATCH_SIZE 16
+
+/* Statistics are only collected when enabled at compile time. */
+#ifdef HTABLE_STATS
+# define STAT(ht, counter) (ht)->stats.counter++
+#else
+# define STAT(ht, counter) do {} while(0)
+#endif
 
 struct entry {
   const void *key;
   void *data;
 
+  /* cached hash of the key, compared before calling the compare function */
+  uint32_t hash;
+
   struct entry *next;
 };
 
+struct table {
+  struct entry **buckets;
+  unsigned int nbuckets;
+};
+
 struct htable {
   uint32_t (*hash)(const void *);
+  uint32_t (*seeded_hash)(const void *, const void *);
+  unsigned char seed[HASH_SEED_SIZE];
+
   bool (*compare)(const void *, const void *);
   void (*destroy)(void *);
 
-  unsigned int nbuckets;
-
-  struct entry *buckets[];
+  slab_t pool; /* entries */
+
+  unsigned int count;       /* number of entries */
+  unsigned int min_buckets; /* never shrink under the initial size */
+
+  /* While the table is resized, entries are migrated incrementally from the
+     first table to the second. Buckets of the first table before rehash_idx
+     have already been migrated. So an entry is always in the second table
+     when its bucket in the first table is before rehash_idx. */
+  struct table tables[2];
+  unsigned int rehash_idx;
+
+#ifdef HTABLE_STATS
+  struct {
+    unsigned long lookups;
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long probes;
+    unsigned long inserts;
+    unsigned long deletes;
+  } stats;
+#endif
 };
 
-htable_t ht_create(unsigned int nbuckets,
-                   uint32_t (*hash)(const void *),
-                   bool (*compare)(const void *, const void *),
-                   void (*destroy)(void *))
+static bool rehashing(const struct htable *ht)
+{
+  return ht->tables[1].buckets != NULL;
+}
+
+static bool alloc_table(struct table *table, unsigned int nbuckets)
+{
+  table->buckets = calloc(nbuckets, sizeof(struct entry *));
+  if(!table->buckets)
+    return false;
+
+  table->nbuckets = nbuckets;
+
+  return true;
+}
+
+/* Return a reference to the bucket where the entry with this hash must be. */
+static struct entry ** bucket(const struct htable *ht, uint32_t hash)
+{
+  const struct table *table = ht->tables;
+  uint32_t index = IDX(hash, table->nbuckets);
+
+  if(rehashing(ht) && index < ht->rehash_idx) {
+    table = &ht->tables[1];
+    index = IDX(hash, table->nbuckets);
+  }
+
+  return &table->buckets[index];
+}
+
+static uint32_t hash_key(const struct htable *ht, const void *key)
+{
+  if(ht->seeded_hash)
+    return ht->seeded_hash(key, ht->seed);
+  return ht->hash(key);
+}
+
+static void start_rehash(struct htable *ht, unsigned int nbuckets)
+{
+  /* if we cannot allocate the new table, we just keep the old one */
+  if(!alloc_table(&ht->tables[1], nbuckets))
+    return;
+
+  ht->rehash_idx = 0;
+}
+
+static void rehash_step(struct htable *ht)
+{
+  struct table *old = &ht->tables[0];
+  struct table *new = &ht->tables[1];
+  unsigned int moved        = 0;
+  unsigned int empty_visits = REHASH_STEP * REHASH_EMPTY_VISITS;
+
+  while(moved < REHASH_STEP && ht->rehash_idx < old->nbuckets) {
+    struct entry *entry = old->buckets[ht->rehash_idx];
+
+    if(!entry) {
+      ht->rehash_idx++;
+      if(!--empty_visits)
+        break;
+      continue;
+    }
+
+    while(entry) {
+      struct entry *next = entry->next;
+      uint32_t index     = IDX(entry->hash, new->nbuckets);
+
+      entry->next = new->buckets[index];
+      new->buckets[index] = entry;
+
+      entry = next;
+    }
+
+    old->buckets[ht->rehash_idx++] = NULL;
+    moved++;
+  }
+
+  if(ht->rehash_idx == old->nbuckets) {
+    free(old->buckets);
+    *old = *new;
+    new->buckets = NULL;
+  }
+}
+
+/* Do a rehash step when the table is being resized. */
+static void rehash(struct htable *ht)
+{
+  if(rehashing(ht))
+    rehash_step(ht);
+}
+
+static void check_grow(struct htable *ht)
 {
-  struct htable *ht = malloc(sizeof(struct htable) +            \
-                             sizeof(struct entry) * nbuckets);
+  unsigned int nbuckets = ht->tables[0].nbuckets;
+
+  if(!rehashing(ht) && ht->count > nbuckets * GROW_LOAD && nbuckets << 1)
+    start_rehash(ht, nbuckets << 1);
+}
+
+static void check_shrink(struct htable *ht)
+{
+  unsigned int nbuckets = ht->tables[0].nbuckets;
+  unsigned int target   = ht->min_buckets;
+
+  if(rehashing(ht) || nbuckets <= ht->min_buckets ||
+     ht->count >= nbuckets / SHRINK_LOAD)
+    return;
+
+  /* smallest size that keeps the load factor under one half */
+  while(target < ht->count * 2)
+    target <<= 1;
+
+  if(target < nbuckets)
+    start_rehash(ht, target);
+}
+
+static void * insert_new(struct htable *ht, struct entry **bucket,
+                         uint32_t hash, const void *key, void *data)
+{
+  struct entry *new = slab_alloc(ht->pool);
+
+  if(!new)
+    return NULL;
+
+  new->key  = key;
+  new->data = data;
+  new->hash = hash;
+  new->next = *bucket;
+
+  *bucket = new;
+
+  STAT(ht, inserts);
+  ht->count++;
+  check_grow(ht);
+
+  return data;
+}
+
+/* The entries are carved from the arena when there is one. */
+static struct htable * create(unsigned int nbuckets,
+                              uint32_t (*hash)(const void *),
+                              bool (*compare)(const void *, const void *),
+                              void (*destroy)(void *),
+                              void *arena, size_t arena_size)
+{
+  struct htable *ht = malloc(sizeof(struct htable));
+  unsigned int size = 1;
 
   if(!ht)
     return NULL;
-  memset(ht, 0, sizeof(struct htable) + sizeof(struct entry *) * nbuckets);
+  memset(ht, 0, sizeof(struct htable));
+
+  while(size < nbuckets)
+    size <<= 1;
+
+  if(!alloc_table(&ht->tables[0], size)) {
+    free(ht);
+    return NULL;
+  }
+
+  if(arena)
+    ht->pool = slab_create_arena(sizeof(struct entry), arena, arena_size);
+  else
+    ht->pool = slab_create(sizeof(struct entry), 0);
+  if(!ht->pool) {
+    free(ht->tables[0].buckets);
+    free(ht);
+    return NULL;
+  }
 
-  ht->nbuckets = nbuckets;
+  ht->min_buckets = size;
 
   ht->hash    = hash;
   ht->compare = compare;
@@ -69,6 +281,39 @@ htable_t ht_create(unsigned int nbuckets,
   return ht;
 }
 
+htable_t ht_create(unsigned int nbuckets,
+                   uint32_t (*hash)(const void *),
+                   bool (*compare)(const void *, const void *),
+                   void (*destroy)(void *))
+{
+  return create(nbuckets, hash, compare, destroy, NULL, 0);
+}
+
+htable_t ht_create_arena(unsigned int nbuckets,
+                         uint32_t (*hash)(const void *),
+                         bool (*compare)(const void *, const void *),
+                         void (*destroy)(void *),
+                         void *arena, size_t arena_size)
+{
+  return create(nbuckets, hash, compare, destroy, arena, arena_size);
+}
+
+htable_t ht_create_seeded(unsigned int nbuckets,
+                          uint32_t (*hash)(const void *, const void *),
+                          bool (*compare)(const void *, const void *),
+                          void (*destroy)(void *))
+{
+  struct htable *ht = ht_create(nbuckets, NULL, compare, destroy);
+
+  if(!ht)
+    return NULL;
+
+  ht->seeded_hash = hash;
+  hash_seed(ht->seed, sizeof(ht->seed));
+
+  return ht;
+}
+
 /* also known as ht_insert_or_replace() */
 /* FIXME: In future MAJOR version the name of this function
    must be replaced by ht_insert_or_replace() and ht_search()
@@ -77,12 +322,25 @@ htable_t ht_create(unsigned int nbuckets,
 void * ht_search(htable_t ht, const void *key, void *data)
 {
   struct entry *entry;
-  uint32_t index = IDX(ht->hash(key), ht->nbuckets);
+  struct entry **head;
+  uint32_t hash;
+
+  rehash(ht);
+
+  hash = hash_key(ht, key);
+  head = bucket(ht, hash);
+
+  STAT(ht, lookups);
+
+  for(entry = *head ; entry ; entry = entry->next) {
+    STAT(ht, probes);
+
+    if(entry->hash == hash && ht->compare(entry->key, key)) {
+      STAT(ht, hits);
 
-  for(entry = ht->buckets[index] ; entry ; entry = entry->next) {
-    if(ht->compare(entry->key, key)) {
       if(data) {
-        ht->destroy(entry->data);
+        if(ht->destroy)
+          ht->destroy(entry->data);
         entry->key  = key;
         entry->data = data;
       }
@@ -91,17 +349,10 @@ void * ht_search(htable_t ht, const void *key, void *data)
     }
   }
 
-  if(data) {
-    struct entry *new = malloc(sizeof(struct entry));
+  STAT(ht, misses);
 
-    new->key  = key;
-    new->data = data;
-    new->next = ht->buckets[index];
-
-    ht->buckets[index] = new;
-
-    return data;
-  }
+  if(data)
+    return insert_new(ht, head, hash, key, data);
 
   return NULL;
 }
@@ -109,12 +360,23 @@ void * ht_search(htable_t ht, const void *key, void *data)
 void * ht_replace(htable_t ht, const void *key, void *data)
 {
   struct entry *entry;
-  uint32_t index = IDX(ht->hash(key), ht->nbuckets);
+  uint32_t hash;
+
+  rehash(ht);
+
+  hash = hash_key(ht, key);
+
+  STAT(ht, lookups);
+
+  for(entry = *bucket(ht, hash) ; entry ; entry = entry->next) {
+    STAT(ht, probes);
+
+    if(entry->hash == hash && ht->compare(entry->key, key)) {
+      STAT(ht, hits);
 
-  for(entry = ht->buckets[index] ; entry ; entry = entry->next) {
-    if(ht->compare(entry->key, key)) {
       if(data) {
-        ht->destroy(entry->data);
+        if(ht->destroy)
+          ht->destroy(entry->data);
         entry->key  = key;
         entry->data = data;
       }
@@ -123,32 +385,38 @@ void * ht_replace(htable_t ht, const void *key, void *data)
     }
   }
 
+  STAT(ht, misses);
+
   return NULL;
 }
 
-
 void * ht_insert(htable_t ht, const void *key, void *data)
 {
   struct entry *entry;
-  uint32_t index = IDX(ht->hash(key), ht->nbuckets);
+  struct entry **head;
+  uint32_t hash;
 
-  for(entry = ht->buckets[index] ; entry ; entry = entry->next) {
-    if(ht->compare(entry->key, key))
-      return entry->data;
-  }
+  rehash(ht);
 
-  if(data) {
-    struct entry *new = malloc(sizeof(struct entry));
+  hash = hash_key(ht, key);
+  head = bucket(ht, hash);
 
-    new->key  = key;
-    new->data = data;
-    new->next = ht->buckets[index];
+  STAT(ht, lookups);
 
-    ht->buckets[index] = new;
+  for(entry = *head ; entry ; entry = entry->next) {
+    STAT(ht, probes);
 
-    return data;
+    if(entry->hash == hash && ht->compare(entry->key, key)) {
+      STAT(ht, hits);
+      return entry->data;
+    }
   }
 
+  STAT(ht, misses);
+
+  if(data)
+    return insert_new(ht, head, hash, key, data);
+
   return NULL;
 }
 
@@ -159,86 +427,354 @@ void * ht_lookup(htable_t ht, const void *key,
                  void *optarg)
 {
   struct entry *entry;
-  uint32_t index    = IDX(ht->hash(key), ht->nbuckets);
+  uint32_t hash;
+  void *data;
+
+  rehash(ht);
 
-  for(entry = ht->buckets[index] ; entry ; entry = entry->next)
-    if(ht->compare(entry->key, key))
+  hash = hash_key(ht, key);
+
+  STAT(ht, lookups);
+
+  for(entry = *bucket(ht, hash) ; entry ; entry = entry->next) {
+    STAT(ht, probes);
+
+    if(entry->hash == hash && ht->compare(entry->key, key)) {
+      STAT(ht, hits);
       return entry->data;
+    }
+  }
 
-  entry = malloc(sizeof(struct entry));
-  entry->key  = key;
-  entry->data = retrieve(key, optarg);
-  entry->next = ht->buckets[index];
+  STAT(ht, misses);
 
-  ht->buckets[index] = entry;
+  /* the retrieve function may modify the table,
+     so we locate the bucket again after the call */
+  data = retrieve(key, optarg);
 
-  return entry->data;
+  return insert_new(ht, bucket(ht, hash), hash, key, data);
 }
 
-void ht_walk(htable_t ht, void (*action)(void *, void *), void *data)
+static void search_batch(struct htable *ht, const void *const *keys,
+                         unsigned int n, void **out)
 {
+  struct entry **heads[BATCH_SIZE];
+  struct entry *entries[BATCH_SIZE];
+  uint32_t hashes[BATCH_SIZE];
   unsigned int i;
 
-  for(i = 0 ; i < ht->nbuckets ; i++) {
+  /* hash each key and prefetch the bucket heads */
+  for(i = 0 ; i < n ; i++) {
+    hashes[i] = hash_key(ht, keys[i]);
+    heads[i]  = bucket(ht, hashes[i]);
+    prefetch(heads[i]);
+  }
+
+  /* then prefetch the first entry of each chain */
+  for(i = 0 ; i < n ; i++) {
+    entries[i] = *heads[i];
+    prefetch(entries[i]);
+  }
+
+  /* the memory accesses have overlapped, now compare */
+  for(i = 0 ; i < n ; i++) {
     struct entry *entry;
 
-    for(entry = ht->buckets[i] ; entry ; entry = entry->next)
-      action(entry->data, data);
+    out[i] = NULL;
+
+    STAT(ht, lookups);
+
+    for(entry = entries[i] ; entry ; entry = entry->next) {
+      STAT(ht, probes);
+
+      if(entry->hash == hashes[i] && ht->compare(entry->key, keys[i])) {
+        out[i] = entry->data;
+        break;
+      }
+    }
+
+    if(out[i])
+      STAT(ht, hits);
+    else
+      STAT(ht, misses);
+  }
+}
+
+void ht_search_batch(htable_t ht, const void *const *keys, unsigned int n, void **out)
+{
+  rehash(ht);
+
+  while(n > BATCH_SIZE) {
+    search_batch(ht, keys, BATCH_SIZE, out);
+
+    keys += BATCH_SIZE;
+    out  += BATCH_SIZE;
+    n    -= BATCH_SIZE;
+  }
+
+  search_batch(ht, keys, n, out);
+}
+
+void ht_walk(htable_t ht, void (*action)(void *, void *), void *data)
+{
+  unsigned int t, i;
+
+  for(t = 0 ; t < 2 && ht->tables[t].buckets ; t++) {
+    for(i = 0 ; i < ht->tables[t].nbuckets ; i++) {
+      struct entry *entry;
+
+      for(entry = ht->tables[t].buckets[i] ; entry ; entry = entry->next)
+        action(entry->data, data);
+    }
   }
 }
 
 void ht_walk2(htable_t ht, void (*action)(const void *, void *, void *), void *data)
 {
-  unsigned int i;
+  unsigned int t, i;
 
-  for(i = 0 ; i < ht->nbuckets ; i++) {
-    struct entry *entry;
+  for(t = 0 ; t < 2 && ht->tables[t].buckets ; t++) {
+    for(i = 0 ; i < ht->tables[t].nbuckets ; i++) {
+      struct entry *entry;
 
-    for(entry = ht->buckets[i] ; entry ; entry = entry->next)
-      action(entry->key, entry->data, data);
+      for(entry = ht->tables[t].buckets[i] ; entry ; entry = entry->next)
+        action(entry->key, entry->data, data);
+    }
   }
 }
 
+static uint32_t reverse(uint32_t v)
+{
+  v = ((v >> 1) & 0x55555555) | ((v & 0x55555555) << 1);
+  v = ((v >> 2) & 0x33333333) | ((v & 0x33333333) << 2);
+  v = ((v >> 4) & 0x0f0f0f0f) | ((v & 0x0f0f0f0f) << 4);
+  v = ((v >> 8) & 0x00ff00ff) | ((v & 0x00ff00ff) << 8);
+
+  return (v >> 16) | (v << 16);
+}
+
+/* Increment the cursor from its most significant bits for this mask. */
+static uint32_t next_cursor(uint32_t cursor, uint32_t mask)
+{
+  cursor |= ~mask;
+  cursor  = reverse(cursor);
+  cursor++;
+
+  return reverse(cursor);
+}
+
+static void scan_bucket(struct htable *ht, struct entry **ref,
+                        bool (*action)(const void *, void *, void *),
+                        void *data)
+{
+  while(*ref) {
+    struct entry *entry = *ref;
+
+    if(!action(entry->key, entry->data, data)) {
+      ref = &entry->next;
+      continue;
+    }
+
+    /* delete at cursor */
+    *ref = entry->next;
+
+    if(ht->destroy)
+      ht->destroy(entry->data);
+    slab_free(ht->pool, entry);
+
+    STAT(ht, deletes);
+    ht->count--;
+  }
+}
+
+/* The cursor is incremented from its most significant bits, as in the
+   SCAN command of Redis. When the table grows, buckets are split into
+   buckets that share the same low order bits. Since those bits are
+   visited first, the buckets already visited remain visited. When the
+   table is resized in the middle of a call, we visit the bucket of the
+   smaller table and then all the buckets of the larger table it expands
+   to. */
+uint32_t ht_scan(htable_t ht, uint32_t cursor, unsigned int count,
+                 bool (*action)(const void *, void *, void *), void *data)
+{
+  /* a zero count would wrap around and scan the whole table */
+  if(!count)
+    count = 1;
+
+  rehash(ht);
+
+  do {
+    const struct table *small = &ht->tables[0];
+    const struct table *large = &ht->tables[1];
+    uint32_t small_mask, large_mask;
+
+    if(!rehashing(ht)) {
+      small_mask = small->nbuckets - 1;
+
+      scan_bucket(ht, &small->buckets[cursor & small_mask], action, data);
+      cursor = next_cursor(cursor, small_mask);
+
+      continue;
+    }
+
+    if(small->nbuckets > large->nbuckets) {
+      const struct table *swap = small;
+      small = large;
+      large = swap;
+    }
+
+    small_mask = small->nbuckets - 1;
+    large_mask = large->nbuckets - 1;
+
+    scan_bucket(ht, &small->buckets[cursor & small_mask], action, data);
+
+    do {
+      scan_bucket(ht, &large->buckets[cursor & large_mask], action, data);
+      cursor = next_cursor(cursor, large_mask);
+    } while(cursor & (small_mask ^ large_mask));
+  } while(cursor && --count);
+
+  /* resize only once the scan is over */
+  check_shrink(ht);
+
+  return cursor;
+}
+
 void ht_delete(htable_t ht, const void *key)
 {
   struct entry *entry;
-  struct entry *prev = NULL;
-  uint32_t index     = IDX(ht->hash(key), ht->nbuckets);
+  struct entry **ref;
+  uint32_t hash;
+
+  rehash(ht);
+
+  hash = hash_key(ht, key);
+
+  STAT(ht, lookups);
 
-  for(entry = ht->buckets[index], prev = NULL ;
-      entry ;
-      prev = entry, entry = entry->next)
-    if(ht->compare(entry->key, key))
+  for(ref = bucket(ht, hash) ; *ref ; ref = &(*ref)->next) {
+    STAT(ht, probes);
+
+    if((*ref)->hash == hash && ht->compare((*ref)->key, key))
       break;
+  }
 
-  if(!entry)
+  entry = *ref;
+  if(!entry) {
+    STAT(ht, misses);
     return;
+  }
 
-  if(!prev)
-    ht->buckets[index] = entry->next;
-  else
-    prev->next = entry->next;
+  STAT(ht, hits);
+  STAT(ht, deletes);
 
-  ht->destroy(entry->data);
-  free(entry);
+  *ref = entry->next;
+
+  if(ht->destroy)
+    ht->destroy(entry->data);
+  slab_free(ht->pool, entry);
+
+  ht->count--;
+  check_shrink(ht);
 }
 
-void ht_destroy(htable_t ht)
+unsigned int ht_count(htable_t ht)
 {
-  unsigned int i;
+  return ht->count;
+}
+
+double ht_load_factor(htable_t ht)
+{
+  unsigned int nbuckets = ht->tables[0].nbuckets;
 
-  for(i = 0 ; i < ht->nbuckets ; i++) {
-    struct entry *entry = ht->buckets[i];
+  if(rehashing(ht))
+    nbuckets += ht->tables[1].nbuckets;
 
-    while(entry) {
-      struct entry *f = entry;
+  return (double)ht->count / nbuckets;
+}
+
+#ifdef HTABLE_STATS
+void ht_stats(htable_t ht, struct ht_stats *stats)
+{
+  unsigned int t, i;
+  unsigned int used = 0;
 
-      entry = entry->next;
-      ht->destroy(f->data);
-      free(f);
+  memset(stats, 0, sizeof(struct ht_stats));
+
+  stats->count = ht->count;
+
+  for(t = 0 ; t < 2 && ht->tables[t].buckets ; t++) {
+    stats->nbuckets += ht->tables[t].nbuckets;
+
+    for(i = 0 ; i < ht->tables[t].nbuckets ; i++) {
+      struct entry *entry;
+      unsigned int length = 0;
+
+      for(entry = ht->tables[t].buckets[i] ; entry ; entry = entry->next)
+        length++;
+
+      if(length)
+        used++;
+      if(length > stats->max_chain)
+        stats->max_chain = length;
+
+      stats->histogram[MIN(length, HT_STATS_HISTOGRAM - 1)]++;
     }
   }
 
-  free(ht);
+  /* buckets which are being migrated are empty in the old table, so
+     the mean is computed on the buckets that contain entries */
+  stats->mean_chain = used ? (double)ht->count / used : 0.;
+
+  stats->lookups = ht->stats.lookups;
+  stats->hits    = ht->stats.hits;
+  stats->misses  = ht->stats.misses;
+  stats->probes  = ht->stats.probes;
+  stats->inserts = ht->stats.inserts;
+  stats->deletes = ht->stats.deletes;
 }
 
+void ht_stats_reset(htable_t ht)
+{
+  memset(&ht->stats, 0, sizeof(ht->stats));
+}
+#endif /* HTABLE_STATS */
+
+static void destroy_data(void *data, void *ht)
+{
+  ((struct htable *)ht)->destroy(data);
+}
+
+void ht_clear(htable_t ht)
+{
+  struct table *table = &ht->tables[0];
+
+  if(ht->destroy)
+    ht_walk(ht, destroy_data, ht);
+
+  /* keep the most recent bucket array */
+  if(rehashing(ht)) {
+    free(table->buckets);
+    *table = ht->tables[1];
+    ht->tables[1].buckets = NULL;
+  }
+
+  memset(table->buckets, 0, table->nbuckets * sizeof(struct entry *));
+  slab_reset(ht->pool);
+
+  ht->count = 0;
+}
+
+void ht_destroy(htable_t ht)
+{
+  unsigned int t;
+
+  if(ht->destroy)
+    ht_walk(ht, destroy_data, ht);
+
+  for(t = 0 ; t < 2 && ht->tables[t].buckets ; t++)
+    free(ht->tables[t].buckets);
+
+  /* the entries are released slab per slab */
+  slab_destroy(ht->pool);
+  free(ht);
+}
@@ -25,19 +25,28 @@
 #ifndef _HTABLE_H_
 #define _HTABLE_H_
 
+#include <stdlib.h>
 #include <stdbool.h>
 #include <stdint.h>
 
 typedef struct htable * htable_t;
 
 /* Create a new hash table. The number of buckets should
-   be a power of two. The hash function take the key
+   be a power of two. This is only the initial number of
+   buckets as the table grows and shrinks automatically
+   with the number of entries. The resize is incremental,
+   a few buckets are migrated on each operation so that
+   there is never a long pause. The hash function take the key
    and return a 32 bit hash. Comparison is done on key and
    return true if they are equals, false otherwise. And the
    last function destroy data when necessary. It should be
    used to destroy the key too as long as it is stored
    with the data (for example inside a structure). Not useful
-   though when the key is only an integer.
+   though when the key is only an integer. The destroy function
+   may be NULL when there is nothing to destroy. In this case
+   the table is destroyed in one go without walking the entries.
+
+   Entries are allocated from a pool private to each table.
 
    You can also free the htable entries manually using ht_walk2().
    However you would still have to call ht_destroy() after that. */
@@ -46,6 +55,26 @@ htable_t ht_create(unsigned int nbuckets,
                    bool (*compare)(const void *, const void *),
                    void (*destroy)(void *));
 
+/* Create a hash table whose entries are carved from a caller supplied arena
+   instead of slabs allocated on the heap (see slab_create_arena()). The
+   buckets are still allocated on the heap. Insertions return NULL once the
+   arena is exhausted. The arena is not released when the table is
+   destroyed and must outlive it. */
+htable_t ht_create_arena(unsigned int nbuckets,
+                         uint32_t (*hash)(const void *),
+                         bool (*compare)(const void *, const void *),
+                         void (*destroy)(void *),
+                         void *arena, size_t arena_size);
+
+/* Create a hash table with a keyed hash function such as hash_str_siphash().
+   The hash function receives a random seed of HASH_SEED_SIZE bytes chosen
+   for this table. Use this for tables whose keys come from untrusted
+   sources, so that nobody can predict which keys will collide. */
+htable_t ht_create_seeded(unsigned int nbuckets,
+                          uint32_t (*hash)(const void *, const void *),
+                          bool (*compare)(const void *, const void *),
+                          void (*destroy)(void *));
+
 /* Those function search, insert or replace an entry inside
    the hash table. If data is NULL, all those functions
    revert to a simple lookup in the hash table. If an entry
@@ -90,6 +119,15 @@ void * ht_lookup(htable_t htable, const void *key,
                  void * (*retrieve)(const void *, void *),
                  void *optarg);
 
+/* Search for n keys at once and store the data of each entry
+   in the out array, or NULL if the key was not found. All the
+   keys are hashed first and the buckets and entries prefetched
+   before they are compared. Therefore the cache misses of the
+   different keys overlap. This is faster than calling ht_search()
+   for each key in a loop when the table does not fit in cache
+   (see bench/hash-eval -b). */
+void ht_search_batch(htable_t htable, const void *const *keys, unsigned int n, void **out);
+
 /* Walk through the hash table and apply the action function
    on each entry, passing the entry key, data and an extra data pointer.
    The second version, ht_walk2, also pass the entry key.
@@ -100,11 +138,81 @@ void * ht_lookup(htable_t htable, const void *key,
 void ht_walk(htable_t htable, void (*action)(void *, void *), void *data);
 void ht_walk2(htable_t htable, void (*action)(const void *, void *, void *), void *data);
 
+/* Scan the hash table incrementally. Each call applies the
+   action function on the entries of count buckets (at least
+   one) starting at the specified cursor. It returns the cursor
+   from which the next call should start, or zero when the scan
+   is complete. The first call must start with a zero cursor.
+   The action is in the form:
+     bool action(const void *entry_key, void *entry_data, void *data);
+   When the action returns true, the entry is deleted from the
+   table (the destroy function is applied) without any other
+   lookup. Otherwise the action must not modify the table.
+
+   The table may be freely modified between two calls, even if
+   it is resized. An entry that is present during the whole
+   scan is guaranteed to be visited. It may be visited more
+   than once when the table is resized during the scan though.
+
+   example:
+
+   cursor = 0;
+   do {
+     cursor = ht_scan(htable, cursor, 64, expire, &now);
+     (... do something else ...)
+   } while(cursor); */
+uint32_t ht_scan(htable_t htable, uint32_t cursor, unsigned int count,
+                 bool (*action)(const void *, void *, void *), void *data);
+
 /* Delete the entry specified by key from the hash table.
    The destroy function used at creation is used to destroy
    the data and the key if necessary. */
 void ht_delete(htable_t htable, const void *key);
 
+/* Return the number of entries in the hash table. */
+unsigned int ht_count(htable_t htable);
+
+/* Destroy each entry from the hash table but keep the table
+   itself. The bucket array and the memory of the entries are
+   kept and reused by the next insertions. */
+void ht_clear(htable_t htable);
+
+/* Return the current load factor of the hash table. That is
+   the average number of entries per bucket. */
+double ht_load_factor(htable_t htable);
+
+#ifdef HTABLE_STATS
+/* Statistics about the hash table. These functions are only available
+   when the library is compiled with HTABLE_STATS defined. Otherwise the
+   counters are compiled out and do not cost anything. */
+# define HT_STATS_HISTOGRAM 16
+
+struct ht_stats {
+  unsigned int count;      /* number of entries */
+  unsigned int nbuckets;   /* number of buckets (both tables during a resize) */
+  unsigned int max_chain;  /* length of the longest chain */
+  double mean_chain;       /* mean length of the non-empty chains */
+
+  /* number of buckets with a chain of each length,
+     the last one counts the longer chains too */
+  unsigned int histogram[HT_STATS_HISTOGRAM];
+
+  unsigned long lookups;   /* searches by key (including deletion) */
+  unsigned long hits;      /* searches that found the key */
+  unsigned long misses;    /* searches that did not find the key */
+  unsigned long probes;    /* entries examined by all the searches */
+  unsigned long inserts;   /* entries inserted */
+  unsigned long deletes;   /* entries deleted */
+};
+
+/* Fill the statistics of the hash table. The number of probes per lookup
+   is given by probes / lookups. This walks through the whole table. */
+void ht_stats(htable_t htable, struct ht_stats *stats);
+
+/* Reset the counters of the hash table. */
+void ht_stats_reset(htable_t htable);
+#endif /* HTABLE_STATS */
+
 /* Destroy each entry from the hash table and then destroy
    the hash table itself. */
 void ht_destroy(htable_t htable);
@@ -0,0 +1,309 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hash.h"
+#include "imap.h"
+
+/* Keys are compared by groups of GROUP keys. The match() function returns
+   a bitmask of the keys of a group which are equal to the specified key. */
+#if defined(__AVX2__) && UINTPTR_MAX == UINT64_MAX
+# include <immintrin.h>
+# define GROUP 4
+
+static unsigned int match(const uintptr_t *keys, uintptr_t key)
+{
+  __m256i group = _mm256_loadu_si256((const __m256i *)keys);
+  __m256i cmp   = _mm256_cmpeq_epi64(group, _mm256_set1_epi64x(key));
+
+  return _mm256_movemask_pd(_mm256_castsi256_pd(cmp));
+}
+#elif defined(__SSE4_1__) && UINTPTR_MAX == UINT64_MAX
+# include <smmintrin.h>
+# define GROUP 2
+
+static unsigned int match(const uintptr_t *keys, uintptr_t key)
+{
+  __m128i group = _mm_loadu_si128((const __m128i *)keys);
+  __m128i cmp   = _mm_cmpeq_epi64(group, _mm_set1_epi64x(key));
+
+  return _mm_movemask_pd(_mm_castsi128_pd(cmp));
+}
+#elif defined(__SSE2__) && UINTPTR_MAX == UINT32_MAX
+# include <emmintrin.h>
+# define GROUP 4
+
+static unsigned int match(const uintptr_t *keys, uintptr_t key)
+{
+  __m128i group = _mm_loadu_si128((const __m128i *)keys);
+  __m128i cmp   = _mm_cmpeq_epi32(group, _mm_set1_epi32(key));
+
+  return _mm_movemask_ps(_mm_castsi128_ps(cmp));
+}
+#else /* generic */
+# define GROUP 1
+
+static unsigned int match(const uintptr_t *keys, uintptr_t key)
+{
+  return *keys == key;
+}
+#endif
+
+#define MIN_SIZE 8 /* at least one group */
+
+struct imap {
+  void (*destroy)(void *);
+
+  unsigned int size;  /* number of slots (power of two) */
+  unsigned int count; /* number of entries */
+
+  uintptr_t *keys;
+  void     **values;
+};
+
+static uint32_t hash(uintptr_t key)
+{
+  uint64_t k = key;
+
+  return hash_int_jenkins((const void *)(uintptr_t)(uint32_t)(k ^ (k >> 32)));
+}
+
+/* Return the slot of the key or the empty slot where it should be inserted. */
+static unsigned int find(const struct imap *imap, uintptr_t key, bool *found)
+{
+  unsigned int mask  = imap->size - 1;
+  unsigned int start = hash(key) & mask;
+  unsigned int base  = start & ~(GROUP - 1);
+  unsigned int valid;
+
+  /* Most probes end on the first slot so check it before the groups. */
+  if(imap->keys[start] == key) {
+    *found = true;
+    return start;
+  }
+  else if(imap->keys[start] == IMAP_EMPTY) {
+    *found = false;
+    return start;
+  }
+
+  /* ignore the slots of the first group up to the start of the probe */
+  valid = ~((2U << (start - base)) - 1);
+
+  for(;;) {
+    unsigned int keys   = match(&imap->keys[base], key) & valid;
+    unsigned int empty  = match(&imap->keys[base], IMAP_EMPTY) & valid;
+    unsigned int either = keys | empty;
+
+    if(either) {
+      unsigned int lane = __builtin_ctz(either);
+
+      *found = keys & (1U << lane);
+      return base + lane;
+    }
+
+    base  = (base + GROUP) & mask;
+    valid = ~0U;
+  }
+}
+
+static bool alloc_slots(struct imap *imap, unsigned int size)
+{
+  unsigned int i;
+
+  imap->keys   = malloc(size * sizeof(uintptr_t));
+  imap->values = malloc(size * sizeof(void *));
+
+  if(!imap->keys || !imap->values) {
+    free(imap->keys);
+    free(imap->values);
+    return false;
+  }
+
+  for(i = 0 ; i < size ; i++)
+    imap->keys[i] = IMAP_EMPTY;
+
+  imap->size = size;
+
+  return true;
+}
+
+static bool grow(struct imap *imap)
+{
+  struct imap old = *imap;
+  unsigned int i;
+
+  if(!alloc_slots(imap, old.size << 1)) {
+    *imap = old;
+    return false;
+  }
+
+  for(i = 0 ; i < old.size ; i++) {
+    if(old.keys[i] != IMAP_EMPTY) {
+      bool found;
+      unsigned int idx = find(imap, old.keys[i], &found);
+
+      imap->keys[idx]   = old.keys[i];
+      imap->values[idx] = old.values[i];
+    }
+  }
+
+  free(old.keys);
+  free(old.values);
+
+  return true;
+}
+
+imap_t imap_create(unsigned int size, void (*destroy)(void *))
+{
+  struct imap *imap = malloc(sizeof(struct imap));
+  unsigned int n    = MIN_SIZE;
+
+  if(!imap)
+    return NULL;
+
+  while(n < size)
+    n <<= 1;
+
+  if(!alloc_slots(imap, n)) {
+    free(imap);
+    return NULL;
+  }
+
+  imap->count   = 0;
+  imap->destroy = destroy;
+
+  return imap;
+}
+
+void * imap_get(imap_t imap, uintptr_t key)
+{
+  bool found;
+  unsigned int idx;
+
+  /* the reserved key would match the first empty slot */
+  if(key == IMAP_EMPTY)
+    return NULL;
+
+  idx = find(imap, key, &found);
+
+  return found ? imap->values[idx] : NULL;
+}
+
+void * imap_put(imap_t imap, uintptr_t key, void *value)
+{
+  bool found;
+  unsigned int idx;
+
+  if(key == IMAP_EMPTY)
+    return NULL;
+
+  idx = find(imap, key, &found);
+
+  if(found) {
+    if(imap->destroy)
+      imap->destroy(imap->values[idx]);
+
+    imap->values[idx] = value;
+
+    return value;
+  }
+
+  /* keep the load factor under 3/4 */
+  if(imap->count + 1 > imap->size - (imap->size >> 2)) {
+    if(!grow(imap))
+      return NULL;
+
+    idx = find(imap, key, &found);
+  }
+
+  imap->keys[idx]   = key;
+  imap->values[idx] = value;
+  imap->count++;
+
+  return value;
+}
+
+void imap_del(imap_t imap, uintptr_t key)
+{
+  unsigned int mask = imap->size - 1;
+  unsigned int next, idx;
+  bool found;
+
+  if(key == IMAP_EMPTY)
+    return;
+
+  idx = find(imap, key, &found);
+  if(!found)
+    return;
+
+  if(imap->destroy)
+    imap->destroy(imap->values[idx]);
+  imap->count--;
+
+  /* move back the entries that cannot be reached anymore */
+  for(next = (idx + 1) & mask ;
+      imap->keys[next] != IMAP_EMPTY ;
+      next = (next + 1) & mask) {
+    unsigned int ideal = hash(imap->keys[next]) & mask;
+
+    if(((next - ideal) & mask) >= ((next - idx) & mask)) {
+      imap->keys[idx]   = imap->keys[next];
+      imap->values[idx] = imap->values[next];
+      idx = next;
+    }
+  }
+
+  imap->keys[idx] = IMAP_EMPTY;
+}
+
+unsigned int imap_count(imap_t imap)
+{
+  return imap->count;
+}
+
+void imap_walk(imap_t imap, void (*action)(uintptr_t, void *, void *), void *data)
+{
+  unsigned int i;
+
+  for(i = 0 ; i < imap->size ; i++)
+    if(imap->keys[i] != IMAP_EMPTY)
+      action(imap->keys[i], imap->values[i], data);
+}
+
+void imap_destroy(imap_t imap)
+{
+  unsigned int i;
+
+  if(imap->destroy)
+    for(i = 0 ; i < imap->size ; i++)
+      if(imap->keys[i] != IMAP_EMPTY)
+        imap->destroy(imap->values[i]);
+
+  free(imap->keys);
+  free(imap->values);
+  free(imap);
+}
@@ -0,0 +1,70 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LIBGAWEN_IMAP_H_
+#define _LIBGAWEN_IMAP_H_
+
+#include <stdint.h>
+
+/* This key is reserved to mark the empty slots. It cannot be inserted,
+   imap_put() and imap_get() return NULL and imap_del() does nothing. */
+#define IMAP_EMPTY UINTPTR_MAX
+
+typedef struct imap * imap_t;
+
+/* Hash map specialized for integer keys such as IPv4 addresses or file
+   descriptors. Keys and values are stored in two flat arrays and probed
+   linearly, so there is no allocation per entry and no indirect call for
+   hashing and comparing the keys. When available, the keys are compared
+   several at once with SSE or AVX2 instructions. Keys are hashed with
+   Robert Jenkins's integer hash (see hash_int_jenkins()).
+
+   The size is the initial capacity of the map as it grows automatically.
+   The destroy function, which may be NULL, is used to destroy the values
+   when necessary. */
+imap_t imap_create(unsigned int size, void (*destroy)(void *));
+
+/* Return the value associated to the key or NULL if the key is not present. */
+void * imap_get(imap_t imap, uintptr_t key);
+
+/* Insert the value for this key or replace the value of the key if it is
+   already present. The old value is destroyed. Return the value, or NULL if
+   the map cannot grow or the key is IMAP_EMPTY. */
+void * imap_put(imap_t imap, uintptr_t key, void *value);
+
+/* Delete the key from the map and destroy its value. */
+void imap_del(imap_t imap, uintptr_t key);
+
+/* Return the number of entries in the map. */
+unsigned int imap_count(imap_t imap);
+
+/* Walk through the map and apply the action function on each entry in the form:
+     void action(uintptr_t key, void *value, void *data);
+   The action must not modify the map. */
+void imap_walk(imap_t imap, void (*action)(uintptr_t, void *, void *), void *data);
+
+/* Destroy each entry from the map and then destroy the map itself. */
+void imap_destroy(imap_t imap);
+
+#endif /* _LIBGAWEN_IMAP_H_ */
@@ -0,0 +1,469 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include "hash.h"
+#include "mphf.h"
+
+/* Average number of keys per bucket. */
+#define LAMBDA 4
+
+/* The keys are first placed in a few more positions than keys, that is
+   n + n / SPARE + 1, so that the last buckets still find free positions
+   with small pilots. */
+#define SPARE 32
+
+/* Maximum number of keys in a single bucket, number of pilots tried for a
+   bucket and number of salts tried before giving up the construction. */
+#define MAX_BUCKET_SIZE 64
+#define MAX_PILOT       (1 << 20)
+#define MAX_ATTEMPTS    8
+
+struct mphf {
+  uint32_t (*hash)(const void *);
+  uint32_t (*hash2)(const void *);
+  bool (*compare)(const void *, const void *);
+
+  uint32_t salt;
+  unsigned int n;        /* number of keys */
+  unsigned int m;        /* number of positions */
+  unsigned int nbuckets;
+
+  unsigned int width; /* bits per pilot */
+  uint64_t *pilots;   /* pilot of each bucket packed on width bits */
+  uint32_t *remap;    /* index of each position past n */
+
+  const void **keys;
+  void **values;
+};
+
+/* Hashes derived from the hash of a key. */
+struct derived {
+  uint32_t bucket;
+  uint32_t f;
+};
+
+/* Both hashes of a key are stored in a single 64 bit integer. */
+static uint32_t mix(uint64_t hash, uint32_t salt)
+{
+  uint32_t h1 = hash >> 32;
+  uint32_t h2 = hash;
+
+  return hash_int_jenkins((const void *)(uintptr_t)(h1 ^ salt)) ^
+         hash_int_jenkins((const void *)(uintptr_t)(h2 + salt));
+}
+
+static struct derived derive(uint64_t hash, uint32_t salt, unsigned int nbuckets)
+{
+  struct derived d;
+
+  d.bucket = mix(hash, salt) % nbuckets;
+  d.f      = mix(hash, salt * 0x9e3779b1);
+
+  return d;
+}
+
+static uint64_t key_hash(const struct mphf *mphf, const void *key)
+{
+  uint64_t hash = (uint64_t)mphf->hash(key) << 32;
+
+  if(mphf->hash2)
+    hash |= mphf->hash2(key);
+
+  return hash;
+}
+
+/* The pilot of a bucket moves all its keys to other positions at once. */
+static unsigned int position(uint32_t f, uint32_t pilot, unsigned int m)
+{
+  return (f ^ hash_int_jenkins((const void *)(uintptr_t)pilot)) % m;
+}
+
+static uint32_t get_pilot(const struct mphf *mphf, unsigned int bucket)
+{
+  uint64_t bit       = (uint64_t)bucket * mphf->width;
+  unsigned int shift = bit & 63;
+  uint64_t value     = mphf->pilots[bit >> 6] >> shift;
+
+  if(shift + mphf->width > 64)
+    value |= mphf->pilots[(bit >> 6) + 1] << (64 - shift);
+
+  return value & ((1ULL << mphf->width) - 1);
+}
+
+static void set_pilot(struct mphf *mphf, unsigned int bucket, uint32_t pilot)
+{
+  uint64_t bit       = (uint64_t)bucket * mphf->width;
+  unsigned int shift = bit & 63;
+
+  mphf->pilots[bit >> 6] |= (uint64_t)pilot << shift;
+
+  if(shift + mphf->width > 64)
+    mphf->pilots[(bit >> 6) + 1] |= (uint64_t)pilot >> (64 - shift);
+}
+
+static unsigned int get_index(const struct mphf *mphf, uint64_t hash)
+{
+  struct derived d = derive(hash, mphf->salt, mphf->nbuckets);
+  unsigned int p   = position(d.f, get_pilot(mphf, d.bucket), mphf->m);
+
+  return p < mphf->n ? p : mphf->remap[p - mphf->n];
+}
+
+/* Try to build the function with the current salt. Return false when a
+   pilot could not be found for a bucket. */
+static bool try_build(struct mphf *mphf, const uint64_t *hashes)
+{
+  unsigned int n        = mphf->n;
+  unsigned int m        = mphf->m;
+  unsigned int nbuckets = mphf->nbuckets;
+  struct derived *derived = malloc(n * sizeof(struct derived));
+  unsigned int *start   = calloc(nbuckets + 2, sizeof(unsigned int));
+  unsigned int *members = malloc(n * sizeof(unsigned int));
+  unsigned int *order   = malloc(nbuckets * sizeof(unsigned int));
+  unsigned int *sizes   = calloc(MAX_BUCKET_SIZE + 2, sizeof(unsigned int));
+  uint32_t *pilots      = calloc(nbuckets, sizeof(uint32_t));
+  unsigned char *taken  = calloc(m, 1);
+  uint32_t max_pilot    = 0;
+  bool ret = false;
+  unsigned int i, j;
+
+  if(!derived || !start || !members || !order || !sizes || !pilots || !taken) {
+    errno = ENOMEM;
+    goto exit;
+  }
+
+  /* group the keys by bucket */
+  for(i = 0 ; i < n ; i++) {
+    derived[i] = derive(hashes[i], mphf->salt, nbuckets);
+    start[derived[i].bucket + 2]++;
+  }
+
+  for(i = 0 ; i < nbuckets ; i++)
+    if(start[i + 2] > MAX_BUCKET_SIZE)
+      goto exit;
+
+  for(i = 2 ; i < nbuckets + 2 ; i++)
+    start[i] += start[i - 1];
+  for(i = 0 ; i < n ; i++)
+    members[start[derived[i].bucket + 1]++] = i;
+
+  /* now start[b] is the first member of bucket b, sort the buckets
+     by decreasing size as the largest ones are the hardest to place */
+  for(i = 0 ; i < nbuckets ; i++)
+    sizes[MAX_BUCKET_SIZE - (start[i + 1] - start[i]) + 1]++;
+  for(i = 1 ; i <= MAX_BUCKET_SIZE + 1 ; i++)
+    sizes[i] += sizes[i - 1];
+  for(i = 0 ; i < nbuckets ; i++)
+    order[sizes[MAX_BUCKET_SIZE - (start[i + 1] - start[i])]++] = i;
+
+  /* search the smallest pilot that places each key of the bucket in a free
+     position, the empty buckets come last and keep a zero pilot */
+  for(i = 0 ; i < nbuckets ; i++) {
+    unsigned int bucket = order[i];
+    unsigned int size   = start[bucket + 1] - start[bucket];
+    unsigned int pos[MAX_BUCKET_SIZE];
+    uint32_t pilot;
+
+    if(!size)
+      break;
+
+    for(pilot = 0 ; ; pilot++) {
+      if(pilot == MAX_PILOT)
+        goto exit;
+
+      for(j = 0 ; j < size ; j++) {
+        unsigned int k;
+
+        pos[j] = position(derived[members[start[bucket] + j]].f, pilot, m);
+
+        if(taken[pos[j]])
+          break;
+        for(k = 0 ; k < j && pos[k] != pos[j] ; k++);
+        if(k < j)
+          break;
+      }
+
+      if(j == size)
+        break;
+    }
+
+    for(j = 0 ; j < size ; j++)
+      taken[pos[j]] = 1;
+
+    pilots[bucket] = pilot;
+    if(pilot > max_pilot)
+      max_pilot = pilot;
+  }
+
+  /* most pilots are small, so they are packed on the bits of the largest */
+  for(mphf->width = 0 ; max_pilot >> mphf->width ; mphf->width++);
+
+  mphf->pilots = calloc((uint64_t)nbuckets * mphf->width / 64 + 1, sizeof(uint64_t));
+  mphf->remap  = calloc(m - n, sizeof(uint32_t));
+  if(!mphf->pilots || !mphf->remap) {
+    errno = ENOMEM;
+    goto exit;
+  }
+
+  for(i = 0 ; i < nbuckets ; i++)
+    set_pilot(mphf, i, pilots[i]);
+
+  /* as many positions are free before n as taken after, so the later are
+     remapped to the former to make the function minimal */
+  for(i = n, j = 0 ; i < m ; i++) {
+    if(!taken[i])
+      continue;
+
+    while(taken[j])
+      j++;
+
+    mphf->remap[i - n] = j++;
+  }
+
+  ret = true;
+
+exit:
+  free(derived);
+  free(start);
+  free(members);
+  free(order);
+  free(sizes);
+  free(pilots);
+  free(taken);
+
+  return ret;
+}
+
+static int cmp_hash(const void *a, const void *b)
+{
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+mphf_t mphf_build(const void **keys, void **values, unsigned int n,
+                  uint32_t (*hash)(const void *),
+                  uint32_t (*hash2)(const void *),
+                  bool (*compare)(const void *, const void *))
+{
+  struct mphf *mphf = calloc(1, sizeof(struct mphf));
+  uint64_t *hashes  = malloc((n ? n : 1) * sizeof(uint64_t));
+  uint64_t *sorted  = malloc((n ? n : 1) * sizeof(uint64_t));
+  unsigned int i;
+
+  if(!mphf || !hashes || !sorted) {
+    errno = ENOMEM;
+    goto error;
+  }
+
+  mphf->hash     = hash;
+  mphf->hash2    = hash2;
+  mphf->compare  = compare;
+  mphf->n        = n;
+  mphf->m        = n + n / SPARE + 1;
+  mphf->nbuckets = n / LAMBDA + 1;
+
+  for(i = 0 ; i < n ; i++)
+    hashes[i] = key_hash(mphf, keys[i]);
+
+  /* keys with the same hashes cannot be separated */
+  memcpy(sorted, hashes, n * sizeof(uint64_t));
+  qsort(sorted, n, sizeof(uint64_t), cmp_hash);
+  for(i = 1 ; i < n ; i++) {
+    if(sorted[i] == sorted[i - 1]) {
+      errno = EINVAL;
+      goto error;
+    }
+  }
+
+  for(i = 0 ; n && i < MAX_ATTEMPTS ; i++) {
+    mphf->salt = 0x7ed55d16 + i;
+
+    errno = 0;
+    if(try_build(mphf, hashes))
+      break;
+    if(errno == ENOMEM)
+      goto error;
+  }
+
+  if(i == MAX_ATTEMPTS) {
+    errno = EINVAL;
+    goto error;
+  }
+
+  /* the values and the keys are stored in the order of their index */
+  if(values && n) {
+    mphf->values = malloc(n * sizeof(void *));
+    if(!mphf->values) {
+      errno = ENOMEM;
+      goto error;
+    }
+
+    for(i = 0 ; i < n ; i++)
+      mphf->values[get_index(mphf, hashes[i])] = values[i];
+  }
+
+  if(compare && n) {
+    mphf->keys = malloc(n * sizeof(void *));
+    if(!mphf->keys) {
+      errno = ENOMEM;
+      goto error;
+    }
+
+    for(i = 0 ; i < n ; i++)
+      mphf->keys[get_index(mphf, hashes[i])] = keys[i];
+  }
+
+  free(hashes);
+  free(sorted);
+
+  return mphf;
+
+error:
+  free(hashes);
+  free(sorted);
+  if(mphf)
+    mphf_destroy(mphf);
+
+  return NULL;
+}
+
+unsigned int mphf_index(mphf_t mphf, const void *key)
+{
+  if(!mphf->n)
+    return 0;
+
+  return get_index(mphf, key_hash(mphf, key));
+}
+
+void * mphf_search(mphf_t mphf, const void *key)
+{
+  unsigned int index;
+
+  if(!mphf->n)
+    return NULL;
+
+  index = mphf_index(mphf, key);
+
+  if(mphf->keys && !mphf->compare(mphf->keys[index], key))
+    return NULL;
+
+  return mphf->values ? mphf->values[index] : NULL;
+}
+
+unsigned int mphf_size(mphf_t mphf)
+{
+  return mphf->n;
+}
+
+size_t mphf_bits(mphf_t mphf)
+{
+  return (size_t)mphf->nbuckets * mphf->width +
+         (size_t)(mphf->m - mphf->n) * 32;
+}
+
+void mphf_emit(mphf_t mphf, FILE *f, const char *name,
+               const char *hash, const char *hash2)
+{
+  unsigned int words = (uint64_t)mphf->nbuckets * mphf->width / 64 + 1;
+  unsigned int i;
+
+  fprintf(f, "/* Minimal perfect hash function generated by mphf_emit(). */\n\n");
+
+  /* without keys there is no array to emit and every key has index 0 */
+  if(!mphf->n) {
+    fprintf(f, "static unsigned int %s_index(const void *key)\n"
+               "{\n"
+               "  (void)key;\n"
+               "  return 0;\n"
+               "}\n", name);
+    return;
+  }
+
+  fprintf(f, "static const uint64_t %s_pilots[%u] = {", name, words);
+  for(i = 0 ; i < words ; i++)
+    fprintf(f, "%s0x%016llxULL,", i % 3 ? " " : "\n  ", (unsigned long long)mphf->pilots[i]);
+  fprintf(f, "\n};\n\n");
+
+  fprintf(f, "static const uint32_t %s_remap[%u] = {", name, mphf->m - mphf->n);
+  for(i = 0 ; i < mphf->m - mphf->n ; i++)
+    fprintf(f, "%s%u,", i % 8 ? " " : "\n  ", mphf->remap[i]);
+  fprintf(f, "\n};\n\n");
+
+  fprintf(f, "static uint32_t %s_mix(uint32_t h1, uint32_t h2, uint32_t salt)\n"
+             "{\n"
+             "  return hash_int_jenkins((const void *)(uintptr_t)(h1 ^ salt)) ^\n"
+             "         hash_int_jenkins((const void *)(uintptr_t)(h2 + salt));\n"
+             "}\n\n", name);
+
+  fprintf(f, "static uint32_t %s_pilot(uint32_t bucket)\n"
+             "{\n"
+             "  uint64_t bit       = (uint64_t)bucket * %uU;\n"
+             "  unsigned int shift = bit & 63;\n"
+             "  uint64_t value     = %s_pilots[bit >> 6] >> shift;\n"
+             "\n"
+             "  if(shift + %uU > 64)\n"
+             "    value |= %s_pilots[(bit >> 6) + 1] << (64 - shift);\n"
+             "\n"
+             "  return value & 0x%llxULL;\n"
+             "}\n\n",
+          name, mphf->width, name, mphf->width, name,
+          (unsigned long long)((1ULL << mphf->width) - 1));
+
+  fprintf(f, "static unsigned int %s_index(const void *key)\n"
+             "{\n"
+             "  uint32_t h1     = %s(key);\n"
+             "  uint32_t h2     = %s%s;\n"
+             "  uint32_t bucket = %s_mix(h1, h2, 0x%08xU) %% %uU;\n"
+             "  uint32_t f      = %s_mix(h1, h2, 0x%08xU);\n"
+             "  uint32_t pilot  = %s_pilot(bucket);\n"
+             "  uint32_t p      = (f ^ hash_int_jenkins((const void *)(uintptr_t)pilot)) %% %uU;\n"
+             "\n"
+             "  return p < %uU ? p : %s_remap[p - %uU];\n"
+             "}\n",
+          name, hash, hash2 ? hash2 : "0", hash2 ? "(key)" : "",
+          name, mphf->salt, mphf->nbuckets,
+          name, mphf->salt * 0x9e3779b1,
+          name,
+          mphf->m,
+          mphf->n, name, mphf->n);
+}
+
+void mphf_destroy(mphf_t mphf)
+{
+  free(mphf->pilots);
+  free(mphf->remap);
+  free(mphf->keys);
+  free(mphf->values);
+  free(mphf);
+}
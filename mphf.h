@@ -0,0 +1,95 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LIBGAWEN_MPHF_H_
+#define _LIBGAWEN_MPHF_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct mphf * mphf_t;
+
+/* Minimal perfect hash function for static key sets. Once built, each key of
+   the set is mapped to a distinct index between 0 and n - 1 with a single
+   probe and without collision. This is useful for tables that are filled
+   once and never modified such as keywords or option names.
+
+   The construction follows the hash and displace algorithms CHD
+   (Belazzougui, Botelho and Dietzfelbinger, 2009) and PTHash (Pibiri and
+   Trani, 2021). Keys are first hashed with the specified hash function and
+   this hash is then mixed with hash_int_jenkins() to derive the bucket and
+   the position of each key. Each bucket of about four keys stores a pilot,
+   the smallest value that moves all its keys to free positions. The pilots
+   are packed on as few bits as the largest needs. Keys are placed in about
+   3% more positions than keys and those extra positions are remapped to the
+   free ones, which costs 32 bits each. The function takes about 4 to 5 bits
+   per key in total (see mphf_bits()).
+
+   Keys with the same hash cannot be told apart. With a 32 bit hash, this
+   becomes likely past a few tens of thousands of keys. So a second hash
+   function, for example hash_str_djb2() along with hash_str_jenkins(), may
+   be specified. It may be NULL for small sets.
+
+   The values array, which may be NULL, contains the value associated to
+   each key. If a compare function is specified, the keys are kept so that
+   mphf_search() can tell whether a key is part of the set. Both are stored
+   in the order of the index of the keys, which takes another pointer per
+   key each. The keys and values themselves are not copied.
+
+   The function returns NULL with errno set to EINVAL when two keys have the
+   same hash (or are duplicated) or ENOMEM on allocation error. */
+mphf_t mphf_build(const void **keys, void **values, unsigned int n,
+                  uint32_t (*hash)(const void *),
+                  uint32_t (*hash2)(const void *),
+                  bool (*compare)(const void *, const void *));
+
+/* Return the index of the key. The result is unspecified when the key was
+   not part of the set used to build the function. */
+unsigned int mphf_index(mphf_t mphf, const void *key);
+
+/* Return the value associated to the key, or NULL if the key was not in the
+   set. This requires the compare function at construction. Otherwise the
+   value of the index of the key is returned whatever the key. */
+void * mphf_search(mphf_t mphf, const void *key);
+
+/* Number of keys in the set. */
+unsigned int mphf_size(mphf_t mphf);
+
+/* Size of the function itself in bits, that is without the keys and the
+   values. */
+size_t mphf_bits(mphf_t mphf);
+
+/* Emit the C source code of the function. This generates the static
+   function name_index(const void *key), which calls the hash functions
+   named hash and hash2 (which may be NULL). Use mphf_index() on each key
+   to emit the lookup tables in the same order at compile time. The
+   generated code depends on stdint.h and hash.h. */
+void mphf_emit(mphf_t mphf, FILE *f, const char *name,
+               const char *hash, const char *hash2);
+
+/* Destroy the perfect hash function. */
+void mphf_destroy(mphf_t mphf);
+
+#endif /* _LIBGAWEN_MPHF_H_ */
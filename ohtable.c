@@ -0,0 +1,306 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ohtable.h"
+
+#define MIN_SIZE 8
+
+/* A zero hash marks an empty slot. */
+#define NORMALIZE(hash) ((hash) ? (hash) : 1)
+
+/* Distance of the slot from the ideal position of its hash. */
+#define DIST(hash, idx, mask) (((idx) - ((hash) & (mask))) & (mask))
+
+struct ohtable {
+  uint32_t (*hash)(const void *);
+  bool (*compare)(const void *, const void *);
+  void (*destroy)(void *);
+
+  unsigned int size;  /* number of slots (power of two) */
+  unsigned int count; /* number of entries */
+
+  const void **keys;
+  void       **data;
+  uint32_t    *hashes;
+};
+
+static bool alloc_slots(struct ohtable *ht, unsigned int size)
+{
+  /* keys, data and hashes are allocated in the same block */
+  void *block = malloc(size * (2 * sizeof(void *) + sizeof(uint32_t)));
+
+  if(!block)
+    return false;
+
+  ht->size   = size;
+  ht->keys   = block;
+  ht->data   = (void **)(ht->keys + size);
+  ht->hashes = (uint32_t *)(ht->data + size);
+
+  memset(ht->hashes, 0, size * sizeof(uint32_t));
+
+  return true;
+}
+
+/* Insert a new entry knowing that the key is not present and that there is
+   enough space left in the table. */
+static void place(struct ohtable *ht, uint32_t hash, const void *key, void *data)
+{
+  unsigned int mask = ht->size - 1;
+  unsigned int idx  = hash & mask;
+  unsigned int dist = 0;
+
+  while(ht->hashes[idx]) {
+    unsigned int slot_dist = DIST(ht->hashes[idx], idx, mask);
+
+    /* steal from the rich */
+    if(slot_dist < dist) {
+      uint32_t    swap_hash = ht->hashes[idx];
+      const void *swap_key  = ht->keys[idx];
+      void       *swap_data = ht->data[idx];
+
+      ht->hashes[idx] = hash;
+      ht->keys[idx]   = key;
+      ht->data[idx]   = data;
+
+      hash = swap_hash;
+      key  = swap_key;
+      data = swap_data;
+      dist = slot_dist;
+    }
+
+    idx = (idx + 1) & mask;
+    dist++;
+  }
+
+  ht->hashes[idx] = hash;
+  ht->keys[idx]   = key;
+  ht->data[idx]   = data;
+}
+
+static bool grow(struct ohtable *ht)
+{
+  struct ohtable old = *ht;
+  unsigned int i;
+
+  if(!alloc_slots(ht, old.size << 1))
+    return false;
+
+  /* hashes are cached so we do not need to call the hash function again */
+  for(i = 0 ; i < old.size ; i++)
+    if(old.hashes[i])
+      place(ht, old.hashes[i], old.keys[i], old.data[i]);
+
+  free(old.keys);
+
+  return true;
+}
+
+static void * insert_new(struct ohtable *ht, uint32_t hash, const void *key, void *data)
+{
+  /* keep the load factor under 3/4 */
+  if((ht->count + 1) > ht->size - (ht->size >> 2) && !grow(ht))
+    return NULL;
+
+  place(ht, hash, key, data);
+  ht->count++;
+
+  return data;
+}
+
+static int find(const struct ohtable *ht, uint32_t hash, const void *key)
+{
+  unsigned int mask = ht->size - 1;
+  unsigned int idx  = hash & mask;
+  unsigned int dist;
+
+  for(dist = 0 ; ht->hashes[idx] ; dist++, idx = (idx + 1) & mask) {
+    uint32_t slot_hash = ht->hashes[idx];
+
+    /* the key would have stolen this slot */
+    if(DIST(slot_hash, idx, mask) < dist)
+      break;
+
+    if(slot_hash == hash && ht->compare(ht->keys[idx], key))
+      return idx;
+  }
+
+  return -1;
+}
+
+ohtable_t oht_create(unsigned int nbuckets,
+                     uint32_t (*hash)(const void *),
+                     bool (*compare)(const void *, const void *),
+                     void (*destroy)(void *))
+{
+  struct ohtable *ht = malloc(sizeof(struct ohtable));
+  unsigned int size  = MIN_SIZE;
+
+  if(!ht)
+    return NULL;
+
+  while(size < nbuckets)
+    size <<= 1;
+
+  if(!alloc_slots(ht, size)) {
+    free(ht);
+    return NULL;
+  }
+
+  ht->count = 0;
+
+  ht->hash    = hash;
+  ht->compare = compare;
+  ht->destroy = destroy;
+
+  return ht;
+}
+
+void * oht_search(ohtable_t ht, const void *key, void *data)
+{
+  uint32_t hash = NORMALIZE(ht->hash(key));
+  int idx       = find(ht, hash, key);
+
+  if(idx >= 0) {
+    if(data) {
+      if(ht->destroy)
+        ht->destroy(ht->data[idx]);
+      ht->keys[idx] = key;
+      ht->data[idx] = data;
+    }
+
+    return ht->data[idx];
+  }
+
+  if(data)
+    return insert_new(ht, hash, key, data);
+
+  return NULL;
+}
+
+void * oht_replace(ohtable_t ht, const void *key, void *data)
+{
+  uint32_t hash = NORMALIZE(ht->hash(key));
+  int idx       = find(ht, hash, key);
+
+  if(idx < 0)
+    return NULL;
+
+  if(data) {
+    if(ht->destroy)
+      ht->destroy(ht->data[idx]);
+    ht->keys[idx] = key;
+    ht->data[idx] = data;
+  }
+
+  return ht->data[idx];
+}
+
+void * oht_insert(ohtable_t ht, const void *key, void *data)
+{
+  uint32_t hash = NORMALIZE(ht->hash(key));
+  int idx       = find(ht, hash, key);
+
+  if(idx >= 0)
+    return ht->data[idx];
+
+  if(data)
+    return insert_new(ht, hash, key, data);
+
+  return NULL;
+}
+
+void * oht_lookup(ohtable_t ht, const void *key,
+                  void * (*retrieve)(const void *, void *),
+                  void *optarg)
+{
+  uint32_t hash = NORMALIZE(ht->hash(key));
+  int idx       = find(ht, hash, key);
+
+  if(idx >= 0)
+    return ht->data[idx];
+
+  return insert_new(ht, hash, key, retrieve(key, optarg));
+}
+
+void oht_walk(ohtable_t ht, void (*action)(void *, void *), void *data)
+{
+  unsigned int i;
+
+  for(i = 0 ; i < ht->size ; i++)
+    if(ht->hashes[i])
+      action(ht->data[i], data);
+}
+
+void oht_walk2(ohtable_t ht, void (*action)(const void *, void *, void *), void *data)
+{
+  unsigned int i;
+
+  for(i = 0 ; i < ht->size ; i++)
+    if(ht->hashes[i])
+      action(ht->keys[i], ht->data[i], data);
+}
+
+void oht_delete(ohtable_t ht, const void *key)
+{
+  unsigned int mask = ht->size - 1;
+  unsigned int next;
+  int idx = find(ht, NORMALIZE(ht->hash(key)), key);
+
+  if(idx < 0)
+    return;
+
+  if(ht->destroy)
+    ht->destroy(ht->data[idx]);
+  ht->count--;
+
+  /* shift back the following entries until one is at its ideal position */
+  for(next = (idx + 1) & mask ;
+      ht->hashes[next] && DIST(ht->hashes[next], next, mask) ;
+      idx = next, next = (next + 1) & mask) {
+    ht->hashes[idx] = ht->hashes[next];
+    ht->keys[idx]   = ht->keys[next];
+    ht->data[idx]   = ht->data[next];
+  }
+
+  ht->hashes[idx] = 0;
+}
+
+void oht_destroy(ohtable_t ht)
+{
+  unsigned int i;
+
+  if(ht->destroy)
+    for(i = 0 ; i < ht->size ; i++)
+      if(ht->hashes[i])
+        ht->destroy(ht->data[i]);
+
+  free(ht->keys);
+  free(ht);
+}
@@ -0,0 +1,75 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LIBGAWEN_OHTABLE_H_
+#define _LIBGAWEN_OHTABLE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct ohtable * ohtable_t;
+
+/* Open addressing hash table. This is a drop-in alternative to the chained
+   hash table from htable.h. Each function oht_xxx() behaves exactly like its
+   ht_xxx() counterpart, so you can switch from one to the other by replacing
+   the ht_ prefix with oht_ and the htable_t type with ohtable_t.
+
+   The table uses Robin Hood hashing with backward shift deletion. Keys, data
+   and hashes are stored in flat arrays so that there is no allocation per
+   entry and a probe only compares the cached hashes until a candidate is
+   found. The table grows automatically when it is three quarters full.
+   Therefore the number of buckets is only the initial capacity (rounded up to
+   a power of two).
+
+   Beware that unlike the chained hash table, entries are moved inside the
+   table on insertion and deletion. So you should not insert or delete entries
+   from within a walk. */
+ohtable_t oht_create(unsigned int nbuckets,
+                     uint32_t (*hash)(const void *),
+                     bool (*compare)(const void *, const void *),
+                     void (*destroy)(void *));
+
+/* See ht_search(), ht_replace() and ht_insert(). These functions return NULL
+   when the table cannot grow to accomodate a new entry. */
+#define oht_insert_or_replace oht_search
+void * oht_search(ohtable_t htable, const void *key, void *data);
+void * oht_replace(ohtable_t htable, const void *key, void *data);
+void * oht_insert(ohtable_t htable, const void *key, void *data);
+
+/* See ht_lookup(). */
+void * oht_lookup(ohtable_t htable, const void *key,
+                  void * (*retrieve)(const void *, void *),
+                  void *optarg);
+
+/* See ht_walk() and ht_walk2(). */
+void oht_walk(ohtable_t htable, void (*action)(void *, void *), void *data);
+void oht_walk2(ohtable_t htable, void (*action)(const void *, void *, void *), void *data);
+
+/* See ht_delete(). */
+void oht_delete(ohtable_t htable, const void *key);
+
+/* See ht_destroy(). */
+void oht_destroy(ohtable_t htable);
+
+#endif /* _LIBGAWEN_OHTABLE_H_ */
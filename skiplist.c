@@ -0,0 +1,387 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef __linux__
+# define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "skiplist.h"
+
+#define MAX_LEVEL 32
+
+/* Nodes removed from the list are kept until this number of nodes is
+   waiting, then we try to advance the epoch and reclaim them. */
+#define RECLAIM_BATCH 64
+
+/* Avoid false sharing between the readers. */
+#define CACHE_LINE 64
+
+#define LOAD(ptr)         __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define STORE(ptr, value) __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+
+struct node {
+  void *data;
+
+  /* list of the removed nodes */
+  struct node *retired_next;
+  unsigned long retired_epoch;
+
+  unsigned int level;
+  struct node *next[]; /* one per level */
+};
+
+/* Epoch of the reader during a read section or zero outside. */
+union reader {
+  struct {
+    unsigned long epoch;
+    bool used;
+  } s;
+
+  char pad[CACHE_LINE];
+};
+
+/* The list is allocated on a cache line and the readers come first so
+   that each of them has its own line, apart from the fields of the list. */
+struct skiplist {
+  union reader readers[SL_MAX_READERS];
+
+  int  (*compare)(const void *, const void *);
+  void (*destroy)(void *);
+
+  struct node *head;
+  unsigned int level; /* highest level in use */
+  unsigned int count;
+  uint32_t seed;      /* for the random levels */
+
+  /* Nodes removed at epoch e can be reclaimed when the global epoch reaches
+     e + 2. The epoch only advances when each reader in a read section has
+     seen the current epoch. So no reader can still hold those nodes. */
+  unsigned long epoch;
+  struct node *retired;
+  struct node *retired_tail;
+  unsigned int nretired;
+};
+
+static struct node * new_node(void *data, unsigned int level)
+{
+  struct node *node = malloc(sizeof(struct node) + level * sizeof(struct node *));
+
+  if(!node)
+    return NULL;
+
+  node->data  = data;
+  node->level = level;
+
+  return node;
+}
+
+static void free_node(struct skiplist *sl, struct node *node)
+{
+  if(sl->destroy && node->data)
+    sl->destroy(node->data);
+  free(node);
+}
+
+skiplist_t sl_create(int  (*compare)(const void *, const void *),
+                     void (*destroy)(void *))
+{
+  void *mem;
+  struct skiplist *sl;
+
+  if(posix_memalign(&mem, CACHE_LINE, sizeof(struct skiplist)))
+    return NULL;
+  sl = mem;
+  memset(sl, 0, sizeof(struct skiplist));
+
+  sl->head = new_node(NULL, MAX_LEVEL);
+  if(!sl->head) {
+    free(sl);
+    return NULL;
+  }
+  memset(sl->head->next, 0, MAX_LEVEL * sizeof(struct node *));
+
+  sl->compare = compare;
+  sl->destroy = destroy;
+  sl->level   = 1;
+  sl->seed    = 0x2545f491;
+  sl->epoch   = 1;
+
+  return sl;
+}
+
+/* Each level is used with a probability of 1/4 relative to the level below. */
+static unsigned int random_level(struct skiplist *sl)
+{
+  uint32_t x = sl->seed;
+  unsigned int level = 1;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  sl->seed = x;
+
+  while(level < MAX_LEVEL && !(x & 3)) {
+    level++;
+    x >>= 2;
+  }
+
+  return level;
+}
+
+/* Try to advance the epoch and reclaim the nodes that no reader can see. */
+static void reclaim(struct skiplist *sl)
+{
+  unsigned long epoch = sl->epoch;
+  bool quiescent = true;
+  int i;
+
+  /* order the unlinks before reading the epochs of the readers */
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+  for(i = 0 ; i < SL_MAX_READERS ; i++) {
+    unsigned long reader = LOAD(&sl->readers[i].s.epoch);
+
+    if(reader && reader != epoch) {
+      quiescent = false;
+      break;
+    }
+  }
+
+  if(quiescent)
+    __atomic_store_n(&sl->epoch, ++epoch, __ATOMIC_SEQ_CST);
+
+  while(sl->retired && sl->retired->retired_epoch + 2 <= epoch) {
+    struct node *node = sl->retired;
+
+    sl->retired = node->retired_next;
+    free_node(sl, node);
+    sl->nretired--;
+  }
+
+  if(!sl->retired)
+    sl->retired_tail = NULL;
+}
+
+static void retire(struct skiplist *sl, struct node *node)
+{
+  node->retired_next  = NULL;
+  node->retired_epoch = sl->epoch;
+
+  if(sl->retired_tail)
+    sl->retired_tail->retired_next = node;
+  else
+    sl->retired = node;
+  sl->retired_tail = node;
+
+  if(++sl->nretired >= RECLAIM_BATCH)
+    reclaim(sl);
+}
+
+/* Writer only. Find the last node before the data at each level. Return the
+   first node not less than the data. */
+static struct node * find_update(struct skiplist *sl, const void *data, struct node **update)
+{
+  struct node *node = sl->head;
+  int i;
+
+  for(i = sl->level - 1 ; i >= 0 ; i--) {
+    while(node->next[i] && sl->compare(data, node->next[i]->data) > 0)
+      node = node->next[i];
+    update[i] = node;
+  }
+
+  return node->next[0];
+}
+
+void * sl_insert(skiplist_t sl, void *data)
+{
+  struct node *update[MAX_LEVEL];
+  struct node *found = find_update(sl, data, update);
+  struct node *node;
+  unsigned int i, level;
+
+  /* Readers may be on the old node, so it is replaced by a new one. */
+  if(found && !sl->compare(data, found->data)) {
+    node = new_node(data, found->level);
+    if(!node)
+      return NULL;
+
+    for(i = 0 ; i < found->level ; i++)
+      node->next[i] = found->next[i];
+    for(i = 0 ; i < found->level ; i++)
+      STORE(&update[i]->next[i], node);
+
+    retire(sl, found);
+    return data;
+  }
+
+  level = random_level(sl);
+  node  = new_node(data, level);
+  if(!node)
+    return NULL;
+
+  for(i = sl->level ; i < level ; i++)
+    update[i] = sl->head;
+  if(level > sl->level)
+    STORE(&sl->level, level);
+
+  /* Link from the bottom so that a reader finding the node on some level
+     can always go down. */
+  for(i = 0 ; i < level ; i++) {
+    node->next[i] = update[i]->next[i];
+    STORE(&update[i]->next[i], node);
+  }
+
+  STORE(&sl->count, sl->count + 1);
+
+  return data;
+}
+
+void sl_delete(skiplist_t sl, const void *data)
+{
+  struct node *update[MAX_LEVEL];
+  struct node *found = find_update(sl, data, update);
+  int i;
+
+  if(!found || sl->compare(data, found->data))
+    return;
+
+  /* Unlink from the top. A reader already on the node still follows its
+     links which stay valid until the node is reclaimed. */
+  for(i = found->level - 1 ; i >= 0 ; i--)
+    STORE(&update[i]->next[i], found->next[i]);
+
+  while(sl->level > 1 && !sl->head->next[sl->level - 1])
+    STORE(&sl->level, sl->level - 1);
+
+  STORE(&sl->count, sl->count - 1);
+
+  retire(sl, found);
+}
+
+int sl_reader_register(skiplist_t sl)
+{
+  int i;
+
+  for(i = 0 ; i < SL_MAX_READERS ; i++) {
+    bool expected = false;
+
+    if(__atomic_compare_exchange_n(&sl->readers[i].s.used, &expected, true, false,
+                                   __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+      return i;
+  }
+
+  return -1;
+}
+
+void sl_reader_unregister(skiplist_t sl, int reader)
+{
+  STORE(&sl->readers[reader].s.used, false);
+}
+
+void sl_read_begin(skiplist_t sl, int reader)
+{
+  unsigned long epoch = LOAD(&sl->epoch);
+
+  /* the links must not be read before the epoch is published */
+  __atomic_store_n(&sl->readers[reader].s.epoch, epoch, __ATOMIC_SEQ_CST);
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void sl_read_end(skiplist_t sl, int reader)
+{
+  STORE(&sl->readers[reader].s.epoch, 0);
+}
+
+/* Return the first node not less than the data. This is the successor
+   compared on the last level, as reading the link again could return a
+   node inserted in the meantime before the data. */
+static struct node * find(struct skiplist *sl, const void *data)
+{
+  struct node *node = sl->head;
+  struct node *next = NULL;
+  int i;
+
+  for(i = LOAD(&sl->level) - 1 ; i >= 0 ; i--) {
+    while((next = LOAD(&node->next[i])) && sl->compare(data, next->data) > 0)
+      node = next;
+  }
+
+  return next;
+}
+
+void * sl_search(skiplist_t sl, const void *data)
+{
+  struct node *node = find(sl, data);
+
+  return node && !sl->compare(data, node->data) ? node->data : NULL;
+}
+
+void * sl_lower_bound(skiplist_t sl, const void *data)
+{
+  struct node *node = find(sl, data);
+
+  return node ? node->data : NULL;
+}
+
+void sl_walk_range(skiplist_t sl, const void *lo, const void *hi, void (*action)(void *))
+{
+  struct node *node = lo ? find(sl, lo) : LOAD(&sl->head->next[0]);
+
+  for(; node ; node = LOAD(&node->next[0])) {
+    if(hi && sl->compare(node->data, hi) >= 0)
+      return;
+    action(node->data);
+  }
+}
+
+unsigned int sl_count(skiplist_t sl)
+{
+  return LOAD(&sl->count);
+}
+
+void sl_destroy(skiplist_t sl)
+{
+  struct node *node = sl->head;
+
+  while(node) {
+    struct node *next = node->next[0];
+
+    free_node(sl, node);
+    node = next;
+  }
+
+  while(sl->retired) {
+    node        = sl->retired;
+    sl->retired = node->retired_next;
+    free_node(sl, node);
+  }
+
+  free(sl);
+}
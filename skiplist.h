@@ -0,0 +1,86 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LIBGAWEN_SKIPLIST_H_
+#define _LIBGAWEN_SKIPLIST_H_
+
+typedef struct skiplist * skiplist_t;
+
+/* Maximal number of readers registered at the same time. */
+#define SL_MAX_READERS 64
+
+/* Concurrent ordered container for a single writer and many readers. The
+   compare and destroy functions are the same as for bst_create(), the
+   destroy function may be NULL.
+
+   Only one thread, the writer, may insert and delete data. It does not need
+   any lock for that. Readers never lock and never wait for the writer. They
+   only have to register once and enclose their searches and walks in
+   sl_read_begin() and sl_read_end(). Within such a section, the data they
+   find stay valid even if the writer deletes or replaces them. Removed data
+   are only destroyed once no reader can see them anymore (epoch based
+   reclamation). So read sections should be short to let the memory be
+   reclaimed. The writer itself may search without registering. */
+skiplist_t sl_create(int  (*compare)(const void *, const void *),
+                     void (*destroy)(void *));
+
+/* Writer only. Insert the data or replace equal data which will be destroyed
+   later. Return the specified data or NULL when there is not enough
+   memory. */
+void * sl_insert(skiplist_t sl, void *data);
+
+/* Writer only. Delete the data which will be destroyed later. */
+void sl_delete(skiplist_t sl, const void *data);
+
+/* Register a new reader. Return its identifier or -1 when there are already
+   SL_MAX_READERS readers. */
+int sl_reader_register(skiplist_t sl);
+void sl_reader_unregister(skiplist_t sl, int reader);
+
+/* Enter and leave a read section. Read sections cannot be nested. */
+void sl_read_begin(skiplist_t sl, int reader);
+void sl_read_end(skiplist_t sl, int reader);
+
+/* Inside a read section. Return the data equal to the specified data or NULL
+   if there is none. */
+void * sl_search(skiplist_t sl, const void *data);
+
+/* Inside a read section. Return the first data which is not less than the
+   specified data or NULL if there is none. */
+void * sl_lower_bound(skiplist_t sl, const void *data);
+
+/* Inside a read section. In-order walk through the data in the range
+   [lo, hi). When lo is NULL the walk starts from the first data, when hi is
+   NULL it goes up to the last data. Concurrent insertions and deletions may
+   or may not be seen by the walk but it always sees the data in order. */
+void sl_walk_range(skiplist_t sl, const void *lo, const void *hi, void (*action)(void *));
+
+/* Return the number of data inside the list. */
+unsigned int sl_count(skiplist_t sl);
+
+/* Destroy each data from the list and then destroy the list itself. This
+   function is not thread safe. */
+void sl_destroy(skiplist_t sl);
+
+#endif /* _LIBGAWEN_SKIPLIST_H_ */
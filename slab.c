@@ -0,0 +1,266 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "slab.h"
+
+/* Default size of a slab when the number of objects is not specified. */
+#define DEFAULT_SLAB_SIZE 65536
+#define MIN_PER_SLAB      16
+
+/* Objects are aligned on the most restrictive of those types. */
+union align {
+  void *ptr;
+  long long ll;
+  double d;
+};
+
+#define ALIGN(size) (((size) + sizeof(union align) - 1) & ~(sizeof(union align) - 1))
+
+struct chunk {
+  struct chunk *next;
+  unsigned int count; /* number of objects */
+  union align objects[];
+};
+
+/* freed objects are chained together */
+struct object {
+  struct object *next;
+};
+
+struct slab {
+  size_t size;           /* aligned size of each object */
+  unsigned int per_slab; /* zero when carved from an arena */
+
+  struct chunk  *chunks;
+  struct chunk  *current; /* slab being carved */
+  struct object *free;
+
+  /* remaining space in the current slab */
+  unsigned char *next;
+  unsigned char *end;
+
+  unsigned char *arena; /* start of the arena if any */
+};
+
+static struct slab * slab_new(size_t size)
+{
+  struct slab *slab;
+
+  /* the aligned size must not wrap around */
+  if(size > SIZE_MAX - sizeof(union align))
+    return NULL;
+
+  slab = malloc(sizeof(struct slab));
+  if(!slab)
+    return NULL;
+
+  /* freed objects must hold the free list link */
+  if(size < sizeof(struct object))
+    size = sizeof(struct object);
+
+  slab->size   = ALIGN(size);
+  slab->chunks  = NULL;
+  slab->current = NULL;
+  slab->free    = NULL;
+  slab->next    = NULL;
+  slab->end     = NULL;
+  slab->arena   = NULL;
+
+  return slab;
+}
+
+slab_t slab_create(size_t size, unsigned int per_slab)
+{
+  struct slab *slab = slab_new(size);
+
+  if(!slab)
+    return NULL;
+
+  if(!per_slab)
+    per_slab = DEFAULT_SLAB_SIZE / slab->size;
+  if(per_slab < MIN_PER_SLAB)
+    per_slab = MIN_PER_SLAB;
+
+  slab->per_slab = per_slab;
+
+  return slab;
+}
+
+slab_t slab_create_arena(size_t size, void *arena, size_t arena_size)
+{
+  struct slab *slab = slab_new(size);
+  uintptr_t start   = (uintptr_t)arena;
+
+  if(!slab)
+    return NULL;
+
+  slab->per_slab = 0;
+
+  /* the arena may not be aligned */
+  slab->next = (unsigned char *)ALIGN(start);
+  slab->end  = (unsigned char *)(start + arena_size);
+
+  if(slab->next > slab->end)
+    slab->next = slab->end;
+
+  slab->arena = slab->next;
+
+  return slab;
+}
+
+static struct chunk * new_chunk(struct slab *slab, unsigned int count)
+{
+  struct chunk *chunk;
+
+  if(count > (SIZE_MAX - sizeof(struct chunk)) / slab->size)
+    return NULL;
+
+  chunk = malloc(sizeof(struct chunk) + slab->size * count);
+  if(!chunk)
+    return NULL;
+
+  chunk->count = count;
+
+  /* insert after the current slab so that it is kept after a reset */
+  if(slab->current) {
+    chunk->next         = slab->current->next;
+    slab->current->next = chunk;
+  }
+  else {
+    chunk->next  = slab->chunks;
+    slab->chunks = chunk;
+  }
+
+  return chunk;
+}
+
+static void use_chunk(struct slab *slab, struct chunk *chunk)
+{
+  slab->current = chunk;
+  slab->next    = (unsigned char *)chunk->objects;
+  slab->end     = slab->next + slab->size * chunk->count;
+}
+
+void * slab_alloc(slab_t slab)
+{
+  void *object;
+
+  if(slab->free) {
+    object     = slab->free;
+    slab->free = slab->free->next;
+
+    return object;
+  }
+
+  if((size_t)(slab->end - slab->next) < slab->size) {
+    struct chunk *chunk;
+
+    if(!slab->per_slab)
+      return NULL;
+
+    /* slabs following the current one are available after a reset */
+    if(slab->current && slab->current->next)
+      chunk = slab->current->next;
+    else {
+      chunk = new_chunk(slab, slab->per_slab);
+      if(!chunk)
+        return NULL;
+    }
+
+    use_chunk(slab, chunk);
+  }
+
+  object      = slab->next;
+  slab->next += slab->size;
+
+  return object;
+}
+
+void * slab_alloc_array(slab_t slab, unsigned int n)
+{
+  size_t size;
+  void *array;
+
+  if(!n || n > SIZE_MAX / slab->size)
+    return NULL;
+
+  size = slab->size * n;
+
+  if((size_t)(slab->end - slab->next) < size) {
+    struct chunk *chunk;
+
+    if(!slab->per_slab)
+      return NULL;
+
+    /* the rest of the current slab is only reused after a reset */
+    chunk = new_chunk(slab, n > slab->per_slab ? n : slab->per_slab);
+    if(!chunk)
+      return NULL;
+
+    use_chunk(slab, chunk);
+  }
+
+  array       = slab->next;
+  slab->next += size;
+
+  return array;
+}
+
+void slab_free(slab_t slab, void *object)
+{
+  struct object *freed = object;
+
+  freed->next = slab->free;
+  slab->free  = freed;
+}
+
+void slab_reset(slab_t slab)
+{
+  slab->free = NULL;
+
+  if(!slab->per_slab) {
+    slab->next = slab->arena;
+    return;
+  }
+
+  if(slab->chunks)
+    use_chunk(slab, slab->chunks);
+}
+
+void slab_destroy(slab_t slab)
+{
+  struct chunk *chunk = slab->chunks;
+
+  while(chunk) {
+    struct chunk *f = chunk;
+
+    chunk = chunk->next;
+    free(f);
+  }
+
+  free(slab);
+}
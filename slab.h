@@ -0,0 +1,68 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LIBGAWEN_SLAB_H_
+#define _LIBGAWEN_SLAB_H_
+
+#include <stdlib.h>
+
+typedef struct slab * slab_t;
+
+/* Create a pool of fixed size objects. Objects are carved from large blocks
+   of memory (the slabs) which contain the specified number of objects each,
+   or a sensible default when zero. This avoids calling malloc() for each
+   object and the memory is released in one go, slab per slab, when the pool
+   is destroyed. Slabs whose size would overflow size_t cannot be allocated,
+   so slab_alloc() returns NULL for them. */
+slab_t slab_create(size_t size, unsigned int per_slab);
+
+/* Create a pool of fixed size objects carved from a caller supplied arena.
+   The pool never allocates memory for the objects itself, so slab_alloc()
+   returns NULL once the arena is exhausted. The arena is not released when
+   the pool is destroyed. */
+slab_t slab_create_arena(size_t size, void *arena, size_t arena_size);
+
+/* Allocate a new object from the pool. Return NULL if the pool cannot
+   allocate a new slab. */
+void * slab_alloc(slab_t slab);
+
+/* Allocate n contiguous objects from the pool as an array. The objects are
+   taken from a new slab when the current one is too small, they do not come
+   from the objects returned to the pool. Each object may still be returned
+   to the pool separately. Return NULL if the pool cannot allocate the slab
+   or when n is zero. */
+void * slab_alloc_array(slab_t slab, unsigned int n);
+
+/* Return an object to the pool. It will be reused by the next allocations. */
+void slab_free(slab_t slab, void *object);
+
+/* Return all the objects to the pool at once. The slabs are kept and reused
+   by the next allocations. */
+void slab_reset(slab_t slab);
+
+/* Release all the objects and the slabs at once and then destroy the pool
+   itself. This is done in O(number of slabs). */
+void slab_destroy(slab_t slab);
+
+#endif /* _LIBGAWEN_SLAB_H_ */
@@ -0,0 +1,413 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef __linux__
+# define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include "crc32.h"
+#include "iobuf.h"
+#include "snapshot.h"
+
+/* The file starts with a header followed by an array of nbuckets + 1
+   offsets. Each bucket spans the records between its offset and the offset
+   of the next bucket. Records and the data inside each record are aligned
+   on eight bytes. */
+#define SNAP_MAGIC "GWNSNAP1"
+#define ALIGN(size) (((size) + 7) & ~7)
+
+struct header {
+  char magic[8];
+  uint32_t nbuckets;
+  uint32_t pad;
+  uint64_t count;
+  uint64_t size;
+};
+
+struct record {
+  uint32_t hash;
+  uint32_t klen;
+  uint32_t dlen;
+  unsigned char bytes[]; /* key, padding and then data */
+};
+
+struct snapshot {
+  const unsigned char *map;
+  size_t size;
+
+  const struct header *header;
+  const uint64_t      *offsets;
+};
+
+/* state of the dump while walking the table */
+struct dump {
+  size_t (*key_size)(const void *);
+  size_t (*data_size)(const void *);
+
+  struct entry {
+    const void *key;
+    const void *data;
+    uint32_t klen;
+    uint32_t dlen;
+    uint32_t hash;
+  } *entries;
+
+  size_t count;
+  size_t allocated;
+  int error; /* errno of the first error or zero */
+};
+
+static uint32_t snap_hash(const void *key, size_t klen)
+{
+  return crc32_c(key, klen, 0);
+}
+
+/* offset of the data from the start of the record */
+static uint64_t data_offset(uint32_t klen)
+{
+  return ALIGN(sizeof(struct record) + (uint64_t)klen);
+}
+
+static uint64_t record_size(uint32_t klen, uint32_t dlen)
+{
+  return ALIGN(data_offset(klen) + dlen);
+}
+
+size_t snap_strsize(const void *str)
+{
+  return strlen(str) + 1;
+}
+
+static void collect(const void *key, void *data, void *optarg)
+{
+  struct dump *dump = optarg;
+  struct entry *entry;
+  size_t klen, dlen;
+
+  if(dump->error)
+    return;
+
+  if(dump->count == dump->allocated) {
+    size_t allocated = dump->allocated ? dump->allocated << 1 : 1024;
+    struct entry *entries = realloc(dump->entries, allocated * sizeof(struct entry));
+
+    if(!entries) {
+      dump->error = ENOMEM;
+      return;
+    }
+
+    dump->entries   = entries;
+    dump->allocated = allocated;
+  }
+
+  klen = dump->key_size(key);
+  dlen = dump->data_size ? dump->data_size(data) : 0;
+
+  /* sizes are stored on 32 bits in the records */
+  if(klen > UINT32_MAX || dlen > UINT32_MAX) {
+    dump->error = EFBIG;
+    return;
+  }
+
+  entry = &dump->entries[dump->count++];
+
+  entry->key  = key;
+  entry->data = data;
+  entry->klen = klen;
+  entry->dlen = dlen;
+  entry->hash = snap_hash(key, klen);
+}
+
+static int write_all(iofile_t file, const void *buf, size_t count)
+{
+  return iobuf_write(file, buf, count) == (ssize_t)count ? 0 : -1;
+}
+
+static int write_snapshot(iofile_t file, const struct dump *dump,
+                          const struct entry **sorted, uint64_t *offsets,
+                          uint32_t nbuckets)
+{
+  static const unsigned char zero[8];
+  struct header header;
+  size_t i;
+
+  memcpy(header.magic, SNAP_MAGIC, sizeof(header.magic));
+  header.nbuckets = nbuckets;
+  header.pad      = 0;
+  header.count    = dump->count;
+  header.size     = offsets[nbuckets];
+
+  if(write_all(file, &header, sizeof(header)) ||
+     write_all(file, offsets, (nbuckets + 1) * sizeof(uint64_t)))
+    return -1;
+
+  for(i = 0 ; i < dump->count ; i++) {
+    const struct entry *entry = sorted[i];
+    struct record record = { entry->hash, entry->klen, entry->dlen };
+    size_t key_end  = sizeof(struct record) + entry->klen;
+    size_t data_end = data_offset(entry->klen) + entry->dlen;
+
+    if(write_all(file, &record, sizeof(struct record)) ||
+       write_all(file, entry->key, entry->klen) ||
+       write_all(file, zero, ALIGN(key_end) - key_end) ||
+       write_all(file, entry->data, entry->dlen) ||
+       write_all(file, zero, ALIGN(data_end) - data_end))
+      return -1;
+  }
+
+  return 0;
+}
+
+int snap_dump(htable_t ht, const char *path,
+              size_t (*key_size)(const void *),
+              size_t (*data_size)(const void *))
+{
+  struct dump dump = { key_size, data_size, NULL, 0, 0, 0 };
+  const struct entry **sorted = NULL;
+  uint64_t *offsets = NULL;
+  size_t *index     = NULL;
+  uint32_t nbuckets = 1;
+  iofile_t file;
+  size_t i;
+  int ret = -1;
+
+  ht_walk2(ht, collect, &dump);
+
+  /* load factor under one */
+  while(nbuckets < dump.count)
+    nbuckets <<= 1;
+
+  sorted  = malloc((dump.count ? dump.count : 1) * sizeof(struct entry *));
+  offsets = calloc(nbuckets + 1, sizeof(uint64_t));
+  index   = calloc(nbuckets + 1, sizeof(size_t));
+
+  if(dump.error) {
+    errno = dump.error;
+    goto exit;
+  }
+
+  if(!sorted || !offsets || !index) {
+    errno = ENOMEM;
+    goto exit;
+  }
+
+  /* counting sort of the entries by bucket, we compute
+     both the size and the number of entries of each bucket */
+  for(i = 0 ; i < dump.count ; i++) {
+    const struct entry *entry = &dump.entries[i];
+    uint32_t bucket = entry->hash & (nbuckets - 1);
+
+    offsets[bucket + 1] += record_size(entry->klen, entry->dlen);
+    index[bucket + 1]++;
+  }
+
+  offsets[0] = sizeof(struct header) + (nbuckets + 1) * sizeof(uint64_t);
+  for(i = 1 ; i <= nbuckets ; i++) {
+    offsets[i] += offsets[i - 1];
+    index[i]   += index[i - 1];
+  }
+
+  for(i = 0 ; i < dump.count ; i++) {
+    uint32_t bucket = dump.entries[i].hash & (nbuckets - 1);
+    sorted[index[bucket]++] = &dump.entries[i];
+  }
+
+  file = iobuf_open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if(!file)
+    goto exit;
+
+  ret = write_snapshot(file, &dump, sorted, offsets, nbuckets);
+
+  if(iobuf_close(file) < 0)
+    ret = -1;
+
+exit:
+  free(dump.entries);
+  free(sorted);
+  free(offsets);
+  free(index);
+
+  return ret;
+}
+
+/* The offsets are only checked once here. They must start right after the
+   offsets array, be aligned and never decrease up to the end of the file.
+   The records themselves are checked against the end of their bucket as
+   they are read (see get_record()). */
+static bool check_offsets(const struct snapshot *snap)
+{
+  uint32_t nbuckets = snap->header->nbuckets;
+  uint32_t i;
+
+  if(snap->offsets[0] != sizeof(struct header) + (nbuckets + 1) * sizeof(uint64_t))
+    return false;
+
+  for(i = 0 ; i < nbuckets ; i++)
+    if(snap->offsets[i + 1] < snap->offsets[i] || snap->offsets[i + 1] & 7)
+      return false;
+
+  return snap->offsets[nbuckets] <= snap->header->size;
+}
+
+snap_t snap_open(const char *path)
+{
+  struct snapshot *snap;
+  struct stat st;
+  void *map;
+  int fd;
+
+  fd = open(path, O_RDONLY);
+  if(fd < 0)
+    return NULL;
+
+  if(fstat(fd, &st) < 0)
+    goto close;
+
+  if((size_t)st.st_size < sizeof(struct header)) {
+    errno = EINVAL;
+    goto close;
+  }
+
+  map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if(map == MAP_FAILED)
+    goto close;
+
+  /* the mapping remains valid after the file is closed */
+  close(fd);
+
+  snap = malloc(sizeof(struct snapshot));
+  if(!snap) {
+    munmap(map, st.st_size);
+    return NULL;
+  }
+
+  snap->map     = map;
+  snap->size    = st.st_size;
+  snap->header  = map;
+  snap->offsets = (const uint64_t *)(snap->header + 1);
+
+  if(memcmp(snap->header->magic, SNAP_MAGIC, sizeof(snap->header->magic)) ||
+     snap->header->size != (uint64_t)st.st_size ||
+     !snap->header->nbuckets ||
+     (snap->header->nbuckets & (snap->header->nbuckets - 1)) ||
+     sizeof(struct header) + (snap->header->nbuckets + 1) * sizeof(uint64_t) > snap->size ||
+     !check_offsets(snap)) {
+    snap_close(snap);
+    errno = EINVAL;
+    return NULL;
+  }
+
+  return snap;
+
+close:
+  close(fd);
+  return NULL;
+}
+
+/* Return the record at this offset or NULL when it does not fit before the
+   end of its bucket, in which case the file is corrupted. */
+static const struct record * get_record(const struct snapshot *snap,
+                                        uint64_t offset, uint64_t end)
+{
+  const struct record *record;
+
+  if(end - offset < sizeof(struct record))
+    return NULL;
+
+  record = (const struct record *)(snap->map + offset);
+  if(record_size(record->klen, record->dlen) > end - offset)
+    return NULL;
+
+  return record;
+}
+
+const void * snap_search(snap_t snap, const void *key, size_t klen, size_t *dlen)
+{
+  uint32_t hash   = snap_hash(key, klen);
+  uint32_t bucket = hash & (snap->header->nbuckets - 1);
+  uint64_t offset = snap->offsets[bucket];
+  uint64_t end    = snap->offsets[bucket + 1];
+
+  while(offset < end) {
+    const struct record *record = get_record(snap, offset, end);
+
+    if(!record)
+      break;
+
+    if(record->hash == hash && record->klen == klen &&
+       !memcmp(record->bytes, key, klen)) {
+      if(dlen)
+        *dlen = record->dlen;
+
+      return (const unsigned char *)record + data_offset(klen);
+    }
+
+    offset += record_size(record->klen, record->dlen);
+  }
+
+  return NULL;
+}
+
+void snap_walk(snap_t snap,
+               void (*action)(const void *, size_t, const void *, size_t, void *),
+               void *optarg)
+{
+  uint64_t offset = snap->offsets[0];
+  uint64_t end    = snap->offsets[snap->header->nbuckets];
+
+  while(offset < end) {
+    const struct record *record = get_record(snap, offset, end);
+
+    if(!record)
+      break;
+
+    action(record->bytes, record->klen,
+           (const unsigned char *)record + data_offset(record->klen),
+           record->dlen, optarg);
+
+    offset += record_size(record->klen, record->dlen);
+  }
+}
+
+size_t snap_count(snap_t snap)
+{
+  return snap->header->count;
+}
+
+void snap_close(snap_t snap)
+{
+  munmap((void *)snap->map, snap->size);
+  free(snap);
+}
@@ -0,0 +1,86 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LIBGAWEN_SNAPSHOT_H_
+#define _LIBGAWEN_SNAPSHOT_H_
+
+#include <stdlib.h>
+
+#include "htable.h"
+
+typedef struct snapshot * snap_t;
+
+/* Snapshots are read-only hash tables stored in a compact file format which
+   is queried directly from a memory mapping of the file. There is no
+   deserialization, so opening a snapshot only checks its index of buckets
+   and the memory is shared by all the processes which open the same file.
+
+   Keys and data are stored as raw bytes, so the file may only be read on a
+   machine with the same byte order. Keys are hashed with crc32_c() and
+   compared byte per byte. The data of each entry is aligned on eight bytes
+   inside the mapping. */
+
+/* Write the content of a hash table into a snapshot file. The key_size and
+   data_size functions return the size of the memory pointed by the key and
+   data of an entry. Use snap_strsize() for strings, a function returning a
+   constant for fixed size keys and so on. The data_size function may be NULL
+   when only the keys have to be stored. Keys and data are limited to
+   UINT32_MAX bytes, larger ones fail with EFBIG. The function returns 0 on
+   success or -1 on error with errno set appropriately. */
+int snap_dump(htable_t htable, const char *path,
+              size_t (*key_size)(const void *),
+              size_t (*data_size)(const void *));
+
+/* Size of a string including its terminating null byte. */
+size_t snap_strsize(const void *str);
+
+/* Map a snapshot file into memory. Return NULL on error with errno set
+   appropriately. Files whose header or bucket offsets are invalid, for
+   example because they were truncated, are rejected with EINVAL. The
+   records are checked as they are read, so that a corrupted record ends
+   the search or the walk of its bucket instead of reading outside of the
+   mapping. */
+snap_t snap_open(const char *path);
+
+/* Search for a key in the snapshot. Return a pointer to the data of the
+   entry inside the mapping or NULL if the key was not found. When dlen is
+   not NULL, it is set to the size of the data. */
+const void * snap_search(snap_t snap, const void *key, size_t klen, size_t *dlen);
+
+/* Walk through the snapshot and apply the action function on each entry in
+   the form:
+     void action(const void *key, size_t klen, const void *data, size_t dlen, void *optarg);
+*/
+void snap_walk(snap_t snap,
+               void (*action)(const void *, size_t, const void *, size_t, void *),
+               void *optarg);
+
+/* Number of entries in the snapshot. */
+size_t snap_count(snap_t snap);
+
+/* Unmap the snapshot. The pointers returned by snap_search() are not valid
+   anymore after this call. */
+void snap_close(snap_t snap);
+
+#endif /* _LIBGAWEN_SNAPSHOT_H_ */
@@ -0,0 +1,135 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Regression tests for the binary sort trees. The data are integers stored
+   in the pointers so that zero, that is NULL, is a valid datum. */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "bst.h"
+
+#define CHECK(cond) do {                                        \
+    if(!(cond)) {                                               \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+      exit(EXIT_FAILURE);                                       \
+    }                                                           \
+  } while(0)
+
+static int destroyed;
+static intptr_t walked[32];
+static int nb_walked;
+
+static int compare(const void *a, const void *b)
+{
+  intptr_t x = (intptr_t)a, y = (intptr_t)b;
+  return (x > y) - (x < y);
+}
+
+static void destroy(void *data)
+{
+  (void)data;
+  destroyed++;
+}
+
+static void walk(void *data)
+{
+  walked[nb_walked++] = (intptr_t)data;
+}
+
+static bst_t create_range(intptr_t lo, intptr_t hi)
+{
+  bst_t bst = bst_create(compare, destroy);
+  intptr_t i;
+
+  CHECK(bst);
+  for(i = lo ; i <= hi ; i++)
+    bst_insert(bst, (void *)i);
+
+  return bst;
+}
+
+static void test_null_datum(void)
+{
+  struct bst_iter iter;
+  bst_t bst = create_range(-5, 5);
+  void *data;
+  int i;
+
+  /* iterator */
+  bst_iter_init(bst, &iter);
+  for(i = -5 ; bst_iter_next(&iter, &data) ; i++)
+    CHECK((intptr_t)data == i);
+  CHECK(i == 6);
+
+  /* walks */
+  nb_walked = 0;
+  bst_walk(bst, walk);
+  CHECK(nb_walked == 11);
+  for(i = 0 ; i < 11 ; i++)
+    CHECK(walked[i] == i - 5);
+
+  nb_walked = 0;
+  bst_walk_range(bst, (void *)-1, (void *)2, walk);
+  CHECK(nb_walked == 3);
+  CHECK(walked[0] == -1 && walked[1] == 0 && walked[2] == 1);
+
+  /* destroy */
+  destroyed = 0;
+  bst_destroy(bst);
+  CHECK(destroyed == 11);
+}
+
+static void test_merge_null_datum(void)
+{
+  bst_t bst   = create_range(-5, 5);
+  bst_t other = create_range(0, 0);
+  unsigned int i;
+
+  destroyed = 0;
+  bst = bst_merge(bst, other);
+  CHECK(bst);
+  CHECK(destroyed == 1); /* the duplicate zero */
+  CHECK(bst_count(bst) == 11);
+  for(i = 0 ; i < 11 ; i++)
+    CHECK((intptr_t)bst_select(bst, i) == (intptr_t)i - 5);
+
+  other = create_range(6, 6);
+  bst   = bst_merge(bst, other);
+  CHECK(bst_count(bst) == 12);
+
+  destroyed = 0;
+  bst_destroy(bst);
+  CHECK(destroyed == 12);
+}
+
+int main(void)
+{
+  test_null_datum();
+  test_merge_null_datum();
+
+  return EXIT_SUCCESS;
+}
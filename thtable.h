@@ -0,0 +1,288 @@
+/* Copyright (c) 2026, David Hauweele <david@hauweele.net>
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+   DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+   ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+   (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+   LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+   ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LIBGAWEN_THTABLE_H_
+#define _LIBGAWEN_THTABLE_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Typed hash tables. Unlike htable.h, the hash table is generated for a
+   specific key and value type with a hash and equality function known at
+   compile time. So there is no indirect call and no boxing of the keys into
+   pointers. Each operation can be inlined and an integer key compiles down
+   to a direct comparison.
+
+   THTABLE_DECLARE(name, key_t, val_t, hash, equal) generates the type
+   struct name and the following functions:
+
+     struct name * name_create(unsigned int size);
+     void          name_destroy(struct name *t);
+     bool          name_get(const struct name *t, key_t key, val_t *val);
+     bool          name_put(struct name *t, key_t key, val_t val);
+     bool          name_del(struct name *t, key_t key);
+     unsigned int  name_count(const struct name *t);
+     void          name_walk(const struct name *t,
+                             void (*action)(key_t, val_t, void *), void *data);
+
+   The hash argument is a function or macro taking a key and returning a 32
+   bit hash. The equal argument is a function or macro taking two keys and
+   returning true when they are equals. name_get() returns true and stores
+   the value when the key is found. name_put() inserts the entry or replaces
+   the value of an existing key, it returns false if the table cannot grow.
+   name_del() returns true if the key was found and removed.
+
+   The table uses linear probing with backward shift deletion and grows when
+   it is three quarters full. Keys and values are copied by value, destroying
+   them when necessary is left to the caller.
+
+   example:
+
+   THTABLE_DECLARE(fdmap, int, struct conn *, th_hash_u32, TH_EQUAL)
+   THTABLE_DECLARE(flows, struct tuple, struct flow *, TH_HASH_MEM, TH_EQUAL_MEM)
+
+   struct fdmap *map = fdmap_create(1024);
+   fdmap_put(map, fd, conn);
+   if(fdmap_get(map, fd, &conn))
+     ...
+*/
+
+/* Equality and hash helpers. The _MEM variants work on the memory of the key
+   and may be used for fixed size structures as long as they have no padding. */
+#define TH_EQUAL(a, b) ((a) == (b))
+#define TH_EQUAL_MEM(a, b) (!memcmp(&(a), &(b), sizeof(a)))
+
+/* Robert Jenkins's integer hash (see hash_int_jenkins()). */
+static inline uint32_t th_hash_u32(uint32_t a)
+{
+  a = (a+0x7ed55d16) + (a<<12);
+  a = (a^0xc761c23c) ^ (a>>19);
+  a = (a+0x165667b1) + (a<<5);
+  a = (a+0xd3a2646c) ^ (a<<9);
+  a = (a+0xfd7046c5) + (a<<3);
+  a = (a^0xb55a4f09) ^ (a>>16);
+
+  return a;
+}
+
+static inline uint32_t th_hash_u64(uint64_t a)
+{
+  return th_hash_u32((uint32_t)a ^ th_hash_u32(a >> 32));
+}
+
+/* Dan Bernstein's hash over a fixed size memory area. */
+static inline uint32_t th_hash_mem(const void *key, size_t size)
+{
+  const unsigned char *s = key;
+  uint32_t hash = 5381;
+
+  while(size--)
+    hash = ((hash << 5) + hash) + *s++;
+
+  return hash;
+}
+
+#define TH_HASH_MEM(key) th_hash_mem(&(key), sizeof(key))
+
+#define THTABLE_DECLARE(name, key_t, val_t, hash, equal)                \
+  struct name {                                                         \
+    unsigned int size;                                                  \
+    unsigned int count;                                                 \
+    unsigned char *used;                                                \
+    key_t *keys;                                                        \
+    val_t *vals;                                                        \
+  };                                                                    \
+                                                                        \
+  static inline bool name##_alloc(struct name *t, unsigned int size)    \
+  {                                                                     \
+    t->used = calloc(size, 1);                                          \
+    t->keys = malloc(size * sizeof(key_t));                             \
+    t->vals = malloc(size * sizeof(val_t));                             \
+    t->size = size;                                                     \
+                                                                        \
+    if(!t->used || !t->keys || !t->vals) {                              \
+      free(t->used);                                                    \
+      free(t->keys);                                                    \
+      free(t->vals);                                                    \
+      return false;                                                     \
+    }                                                                   \
+                                                                        \
+    return true;                                                        \
+  }                                                                     \
+                                                                        \
+  static inline struct name * name##_create(unsigned int size)          \
+  {                                                                     \
+    struct name *t = malloc(sizeof(struct name));                       \
+    unsigned int n = 8;                                                 \
+                                                                        \
+    if(!t)                                                              \
+      return NULL;                                                      \
+                                                                        \
+    while(n < size)                                                     \
+      n <<= 1;                                                          \
+                                                                        \
+    if(!name##_alloc(t, n)) {                                           \
+      free(t);                                                          \
+      return NULL;                                                      \
+    }                                                                   \
+                                                                        \
+    t->count = 0;                                                       \
+                                                                        \
+    return t;                                                           \
+  }                                                                     \
+                                                                        \
+  static inline void name##_destroy(struct name *t)                     \
+  {                                                                     \
+    free(t->used);                                                      \
+    free(t->keys);                                                      \
+    free(t->vals);                                                      \
+    free(t);                                                            \
+  }                                                                     \
+                                                                        \
+  static inline unsigned int name##_find(const struct name *t,          \
+                                         key_t key, bool *found)        \
+  {                                                                     \
+    unsigned int mask = t->size - 1;                                    \
+    unsigned int idx  = (hash(key)) & mask;                             \
+                                                                        \
+    for(; t->used[idx] ; idx = (idx + 1) & mask) {                      \
+      if(equal(t->keys[idx], key)) {                                    \
+        *found = true;                                                  \
+        return idx;                                                     \
+      }                                                                 \
+    }                                                                   \
+                                                                        \
+    *found = false;                                                     \
+    return idx;                                                         \
+  }                                                                     \
+                                                                        \
+  static inline bool name##_grow(struct name *t)                        \
+  {                                                                     \
+    struct name old = *t;                                               \
+    unsigned int i;                                                     \
+                                                                        \
+    if(!name##_alloc(t, old.size << 1)) {                               \
+      *t = old;                                                         \
+      return false;                                                     \
+    }                                                                   \
+                                                                        \
+    for(i = 0 ; i < old.size ; i++) {                                   \
+      if(old.used[i]) {                                                 \
+        bool found;                                                     \
+        unsigned int idx = name##_find(t, old.keys[i], &found);         \
+                                                                        \
+        t->used[idx] = 1;                                               \
+        t->keys[idx] = old.keys[i];                                     \
+        t->vals[idx] = old.vals[i];                                     \
+      }                                                                 \
+    }                                                                   \
+                                                                        \
+    free(old.used);                                                     \
+    free(old.keys);                                                     \
+    free(old.vals);                                                     \
+                                                                        \
+    return true;                                                        \
+  }                                                                     \
+                                                                        \
+  static inline bool name##_get(const struct name *t, key_t key,        \
+                                val_t *val)                             \
+  {                                                                     \
+    bool found;                                                         \
+    unsigned int idx = name##_find(t, key, &found);                     \
+                                                                        \
+    if(found)                                                           \
+      *val = t->vals[idx];                                              \
+                                                                        \
+    return found;                                                       \
+  }                                                                     \
+                                                                        \
+  static inline bool name##_put(struct name *t, key_t key, val_t val)   \
+  {                                                                     \
+    bool found;                                                         \
+    unsigned int idx = name##_find(t, key, &found);                     \
+                                                                        \
+    if(!found) {                                                        \
+      if(t->count + 1 > t->size - (t->size >> 2)) {                     \
+        if(!name##_grow(t))                                             \
+          return false;                                                 \
+        idx = name##_find(t, key, &found);                              \
+      }                                                                 \
+                                                                        \
+      t->used[idx] = 1;                                                 \
+      t->keys[idx] = key;                                               \
+      t->count++;                                                       \
+    }                                                                   \
+                                                                        \
+    t->vals[idx] = val;                                                 \
+                                                                        \
+    return true;                                                        \
+  }                                                                     \
+                                                                        \
+  static inline bool name##_del(struct name *t, key_t key)              \
+  {                                                                     \
+    unsigned int mask = t->size - 1;                                    \
+    unsigned int next;                                                  \
+    bool found;                                                         \
+    unsigned int idx = name##_find(t, key, &found);                     \
+                                                                        \
+    if(!found)                                                          \
+      return false;                                                     \
+                                                                        \
+    /* move back the entries that cannot be reached anymore */          \
+    for(next = (idx + 1) & mask ; t->used[next] ;                       \
+        next = (next + 1) & mask) {                                     \
+      unsigned int ideal = (hash(t->keys[next])) & mask;                \
+                                                                        \
+      if(((next - ideal) & mask) >= ((next - idx) & mask)) {            \
+        t->keys[idx] = t->keys[next];                                   \
+        t->vals[idx] = t->vals[next];                                   \
+        idx = next;                                                     \
+      }                                                                 \
+    }                                                                   \
+                                                                        \
+    t->used[idx] = 0;                                                   \
+    t->count--;                                                         \
+                                                                        \
+    return true;                                                        \
+  }                                                                     \
+                                                                        \
+  static inline unsigned int name##_count(const struct name *t)         \
+  {                                                                     \
+    return t->count;                                                    \
+  }                                                                     \
+                                                                        \
+  static inline void name##_walk(const struct name *t,                  \
+                                 void (*action)(key_t, val_t, void *),  \
+                                 void *data)                            \
+  {                                                                     \
+    unsigned int i;                                                     \
+                                                                        \
+    for(i = 0 ; i < t->size ; i++)                                      \
+      if(t->used[i])                                                    \
+        action(t->keys[i], t->vals[i], data);                           \
+  }
+
+#endif /* _LIBGAWEN_THTABLE_H_ */